@@ -3,6 +3,7 @@
 #include <newdev.h>
 #include <SetupAPI.h>
 
+#include <atomic>
 #include <iostream>
 #include <filesystem>
 #include <mutex>
@@ -15,6 +16,7 @@
 #include "handle.h"
 #include "service.h"
 #include <ktl_shared.h>
+#include <ktl_ring.h>
 
 std::wstring DriverName = L"ktl_test.sys";
 std::wstring ServiceName = L"KTL Test Driver";
@@ -28,6 +30,7 @@ void print_help()
 	std::wcout << L"ktl-ctl.exe stop" << std::endl;
 	std::wcout << L"ktl-ctl.exe test" << std::endl;
 	std::wcout << L"ktl-ctl.exe soak" << std::endl;
+	std::wcout << L"ktl-ctl.exe ring_loopback" << std::endl;
 }
 
 void DriverInstall(const std::wstring& inf_path)
@@ -150,6 +153,220 @@ void RunTest(DWORD ioctl, std::vector<std::system_error>* errors, std::mutex* mt
 	}
 }
 
+// Records per ring, and the number of echo requests pushed through it per run.
+constexpr ULONG RingCapacity = 4096;
+constexpr ULONG RingRequestCount = 200000;
+
+struct RingRegion
+{
+	RingRegion(ULONG capacity) :
+		size_(KtlRingRegionSize(capacity))
+	{
+		// Page aligned, and so cache line aligned.
+		region_ = static_cast<PKTL_RING_REGION>(VirtualAlloc(nullptr, size_, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE));
+		if (!region_)
+			throw std::system_error(std::error_code(::GetLastError(), std::system_category()), "Failed to allocate ring region");
+
+		if (!KtlRingInitialize(region_, size_, capacity))
+			throw std::system_error(std::error_code(ERROR_INVALID_PARAMETER, std::system_category()), "Failed to initialize ring region");
+	}
+
+	RingRegion(const RingRegion&) = delete;
+	RingRegion& operator=(const RingRegion&) = delete;
+
+	~RingRegion()
+	{
+		if (region_)
+			VirtualFree(region_, 0, MEM_RELEASE);
+	}
+
+	PKTL_RING_REGION get()
+	{
+		return region_;
+	}
+
+	SIZE_T size() const
+	{
+		return size_;
+	}
+
+private:
+	PKTL_RING_REGION region_ = nullptr;
+	SIZE_T size_;
+};
+
+KTL_RING_RECORD MakeRingRequest(ULONG sequence)
+{
+	KTL_RING_RECORD record = {};
+	record.Operation = KTL_RING_OP_ECHO;
+	record.Sequence = sequence;
+	record.Length = sizeof(sequence);
+	memcpy(record.Payload, &sequence, sizeof(sequence));
+
+	return record;
+}
+
+void CheckRingResponse(const KTL_RING_RECORD& response, ULONG expected, const std::string& name)
+{
+	ULONG payload;
+	memcpy(&payload, response.Payload, sizeof(payload));
+
+	if (response.Sequence != expected || response.Status != 0 || response.Length != sizeof(payload) || payload != expected)
+		throw std::system_error(std::error_code(ERROR_INVALID_DATA, std::system_category()), "Unexpected response " + std::to_string(response.Sequence) + " (expected " + std::to_string(expected) + ") in " + name + " test");
+}
+
+// Pushes echo requests through a ring registered with the driver. Requests are produced in batches, with one
+// IOCTL per batch to wake the driver, rather than one IOCTL per request.
+void RunRingTest(std::vector<std::system_error>* errors, std::mutex* mtx, const std::string& name)
+{
+	try
+	{
+		Handle h = CreateFileW(L"\\\\.\\" KTL_TEST_DEVICE_USERMODE_NAME,
+			GENERIC_READ,
+			FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE,
+			nullptr,
+			OPEN_EXISTING,
+			FILE_ATTRIBUTE_NORMAL,
+			nullptr);
+
+		if (!h)
+			throw std::system_error(std::error_code(::GetLastError(), std::system_category()), "Failed to open handle for: " + name + " test");
+
+		RingRegion region(RingCapacity);
+		if (!DeviceIoControl(h.get(), IOCTL_KTLTEST_RING_REGISTER, region.get(), static_cast<DWORD>(region.size()), nullptr, 0, nullptr, nullptr))
+			throw std::system_error(std::error_code(::GetLastError(), std::system_category()), "Failed to register " + name);
+
+		KtlRingProducer requests;
+		KtlRingConsumer responses;
+		if (!requests.attach(&region.get()->Requests, KtlRingRequests(region.get()), RingCapacity) ||
+			!responses.attach(&region.get()->Responses, KtlRingResponses(region.get(), RingCapacity), RingCapacity))
+			throw std::system_error(std::error_code(ERROR_INVALID_DATA, std::system_category()), "Failed to attach to " + name);
+
+		std::vector<KTL_RING_RECORD> batch(RingCapacity);
+		ULONG sent = 0;
+		ULONG received = 0;
+		ULONG kicks = 0;
+
+		while (received < RingRequestCount)
+		{
+			ULONG count = 0;
+			while (count < RingCapacity && sent + count < RingRequestCount)
+			{
+				batch[count] = MakeRingRequest(sent + count);
+				++count;
+			}
+
+			sent += requests.push(batch.data(), count);
+
+			DWORD handled = 0;
+			if (!DeviceIoControl(h.get(), IOCTL_KTLTEST_RING_KICK, nullptr, 0, nullptr, 0, &handled, nullptr))
+				throw std::system_error(std::error_code(::GetLastError(), std::system_category()), "Failed to kick " + name);
+
+			++kicks;
+
+			ULONG count_received;
+			while ((count_received = responses.pop(batch.data(), RingCapacity)) != 0)
+			{
+				for (ULONG i = 0; i < count_received; ++i)
+					CheckRingResponse(batch[i], received + i, name);
+
+				received += count_received;
+			}
+
+			if (handled == 0 && received < sent)
+				throw std::system_error(std::error_code(ERROR_INVALID_DATA, std::system_category()), "Driver made no progress in " + name + " test");
+		}
+
+		if (!DeviceIoControl(h.get(), IOCTL_KTLTEST_RING_UNREGISTER, nullptr, 0, nullptr, 0, nullptr, nullptr))
+			throw std::system_error(std::error_code(::GetLastError(), std::system_category()), "Failed to unregister " + name);
+
+		if (kicks > RingRequestCount / RingCapacity + 1)
+			throw std::system_error(std::error_code(ERROR_INVALID_DATA, std::system_category()), "Too many kicks (" + std::to_string(kicks) + ") in " + name + " test");
+	}
+	catch (std::system_error& err)
+	{
+		std::scoped_lock lock(*mtx);
+		errors->emplace_back(std::move(err));
+	}
+}
+
+// Exercises the ring protocol between two threads of this process, without the driver.
+void RingLoopback()
+{
+	RingRegion region(RingCapacity);
+
+	KtlRingProducer producerSide;
+	KtlRingConsumer consumerSide;
+	if (!producerSide.attach(&region.get()->Requests, KtlRingRequests(region.get()), RingCapacity) ||
+		!consumerSide.attach(&region.get()->Requests, KtlRingRequests(region.get()), RingCapacity))
+		throw std::system_error(std::error_code(ERROR_INVALID_DATA, std::system_category()), "Failed to attach to ring");
+
+	std::vector<std::system_error> errors;
+	std::mutex mtx;
+	std::atomic<bool> failed = false;
+
+	auto producer = [&]()
+	{
+		std::vector<KTL_RING_RECORD> batch(64);
+		ULONG sent = 0;
+		while (sent < RingRequestCount && !failed)
+		{
+			ULONG count = 0;
+			while (count < batch.size() && sent + count < RingRequestCount)
+			{
+				batch[count] = MakeRingRequest(sent + count);
+				++count;
+			}
+
+			ULONG pushed = producerSide.push(batch.data(), count);
+			if (pushed == 0)
+				std::this_thread::yield();
+
+			sent += pushed;
+		}
+	};
+
+	auto consumer = [&]()
+	{
+		try
+		{
+			std::vector<KTL_RING_RECORD> batch(64);
+			ULONG received = 0;
+			while (received < RingRequestCount)
+			{
+				ULONG count = consumerSide.pop(batch.data(), static_cast<ULONG>(batch.size()));
+				if (count == 0)
+				{
+					std::this_thread::yield();
+					continue;
+				}
+
+				for (ULONG i = 0; i < count; ++i)
+					CheckRingResponse(batch[i], received + i, "<ring_loopback>");
+
+				received += count;
+			}
+		}
+		catch (std::system_error& err)
+		{
+			failed = true;
+
+			std::scoped_lock lock(mtx);
+			errors.emplace_back(std::move(err));
+		}
+	};
+
+	{
+		std::jthread consumerThr(consumer);
+		std::jthread producerThr(producer);
+	}
+
+	for (const auto& err : errors)
+		throw err;
+
+	std::wcout << L"Passed ring loopback with " << RingRequestCount << L" records." << std::endl;
+}
+
 void DriverTest(const std::wstring_view mode = L"all")
 {
 	std::mutex mtx;
@@ -182,6 +399,51 @@ void DriverTest(const std::wstring_view mode = L"all")
 
 		if (mode == L"all" || mode == L"map")
 			std::jthread tupleTestThr(RunTest, IOCTL_KTLTEST_METHOD_MAP_TEST, &errors, &mtx, "<map>");
+
+		if (mode == L"all" || mode == L"rcu")
+			std::jthread rcuTestThr(RunTest, IOCTL_KTLTEST_METHOD_RCU_TEST, &errors, &mtx, "<rcu>");
+
+		if (mode == L"all" || mode == L"thread_pool")
+			std::jthread thread_poolTestThr(RunTest, IOCTL_KTLTEST_METHOD_THREAD_POOL_TEST, &errors, &mtx, "<thread_pool>");
+
+		if (mode == L"all" || mode == L"algorithm")
+			std::jthread algorithmTestThr(RunTest, IOCTL_KTLTEST_METHOD_ALGORITHM_TEST, &errors, &mtx, "<algorithm>");
+
+		if (mode == L"all" || mode == L"sorted_flat_map")
+			std::jthread sorted_flat_mapTestThr(RunTest, IOCTL_KTLTEST_METHOD_SORTED_FLAT_MAP_TEST, &errors, &mtx, "<sorted_flat_map>");
+
+		if (mode == L"all" || mode == L"btree_map")
+			std::jthread btree_mapTestThr(RunTest, IOCTL_KTLTEST_METHOD_BTREE_MAP_TEST, &errors, &mtx, "<btree_map>");
+
+		if (mode == L"all" || mode == L"path_trie")
+			std::jthread path_trieTestThr(RunTest, IOCTL_KTLTEST_METHOD_PATH_TRIE_TEST, &errors, &mtx, "<path_trie>");
+
+		if (mode == L"all" || mode == L"multi_pattern_matcher")
+			std::jthread multi_pattern_matcherTestThr(RunTest, IOCTL_KTLTEST_METHOD_MULTI_PATTERN_MATCHER_TEST, &errors, &mtx, "<multi_pattern_matcher>");
+
+		if (mode == L"all" || mode == L"glob")
+			std::jthread globTestThr(RunTest, IOCTL_KTLTEST_METHOD_GLOB_TEST, &errors, &mtx, "<glob>");
+
+		if (mode == L"all" || mode == L"bloom_filter")
+			std::jthread bloom_filterTestThr(RunTest, IOCTL_KTLTEST_METHOD_BLOOM_FILTER_TEST, &errors, &mtx, "<bloom_filter>");
+
+		if (mode == L"all" || mode == L"lru_cache")
+			std::jthread lru_cacheTestThr(RunTest, IOCTL_KTLTEST_METHOD_LRU_CACHE_TEST, &errors, &mtx, "<lru_cache>");
+
+		if (mode == L"all" || mode == L"timer_wheel")
+			std::jthread timer_wheelTestThr(RunTest, IOCTL_KTLTEST_METHOD_TIMER_WHEEL_TEST, &errors, &mtx, "<timer_wheel>");
+
+		if (mode == L"all" || mode == L"frozen")
+			std::jthread frozenTestThr(RunTest, IOCTL_KTLTEST_METHOD_FROZEN_TEST, &errors, &mtx, "<frozen>");
+
+		if (mode == L"all" || mode == L"mutex")
+			std::jthread mutexTestThr(RunTest, IOCTL_KTLTEST_METHOD_MUTEX_TEST, &errors, &mtx, "<mutex>");
+
+		if (mode == L"all" || mode == L"shared_mutex")
+			std::jthread shared_mutexTestThr(RunTest, IOCTL_KTLTEST_METHOD_SHARED_MUTEX_TEST, &errors, &mtx, "<shared_mutex>");
+
+		if (mode == L"all" || mode == L"ring")
+			std::jthread ringTestThr(RunRingTest, &errors, &mtx, "<ring>");
 	}
 
 	for (const auto& err : errors)
@@ -241,6 +503,10 @@ int wmain(int argc, wchar_t** argv)
 			DriverTest(mode);
 			DriverStop();
 		}
+		else if (command == L"ring_loopback")
+		{
+			RingLoopback();
+		}
 		else if (command == L"soak")
 		{
 			for (int j = 0; j < 5; ++j)
@@ -79,6 +79,17 @@ namespace ktl
     //utility functions
     static const uint64_t _wyp[5] = { 0xa0761d6478bd642full, 0xe7037ed1a0b428dbull, 0x8ebc6af09c88c6e3ull, 0x589965cc75374cc3ull, 0x1d8e4e27c47d124full };
     static inline uint64_t wyhash64(uint64_t A, uint64_t B) { A ^= _wyp[0]; B ^= _wyp[1];  _wymum(&A, &B);  return _wymix(A ^ _wyp[0], B ^ _wyp[1]); }
+    //single multiply mix for keys which already fit in 64 bits, usable in constant expressions
+    constexpr uint64_t _wymix_constexpr(uint64_t A, uint64_t B) {
+#if defined(_M_X64)
+        if (!__builtin_is_constant_evaluated()) { uint64_t hi; uint64_t lo = _umul128(A, B, &hi); return lo ^ hi; }
+#endif
+        uint64_t ha = A >> 32, hb = B >> 32, la = (uint32_t)A, lb = (uint32_t)B, hi, lo;
+        uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb, t = rl + (rm0 << 32), c = t < rl;
+        lo = t + (rm1 << 32); c += lo < t; hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+        return lo ^ hi;
+    }
+    constexpr uint64_t wyhash_u64(uint64_t key, uint64_t seed) { return _wymix_constexpr(key ^ 0xa0761d6478bd642full, seed ^ 0xe7037ed1a0b428dbull); }
     static inline uint64_t wyrand(uint64_t* seed) { *seed += _wyp[0]; return _wymix(*seed, *seed ^ _wyp[1]); }
     static inline double wy2u01(uint64_t r) { const double _wynorm = 1.0 / (1ull << 52); return (r >> 12) * _wynorm; }
     static inline double wy2gau(uint64_t r) { const double _wynorm = 1.0 / (1ull << 20); return ((r & 0x1fffff) + ((r >> 21) & 0x1fffff) + ((r >> 42) & 0x1fffff)) * _wynorm - 3.0; }
@@ -96,7 +107,8 @@ namespace ktl
                     if (_mm_popcnt_u64(secret[j] ^ secret[i]) != 32) { ok = 0; break; }
 #endif
                 if (!ok)continue;
-                for (uint64_t j = 3; j < 0x100000000ull; j += 2) if (secret[i] % j == 0) { ok = 0; break; }
+                //upstream trial divides up to 2^32, which takes seconds; small factors are enough here
+                for (uint64_t j = 3; j < 0x10000ull; j += 2) if (secret[i] % j == 0) { ok = 0; break; }
             } while (!ok);
         }
     }
@@ -21,3 +21,37 @@
 #if _DEBUG
 #define KTL_TRACE_COPY_ASSIGNMENTS 0
 #endif
+
+
+/*
+ * Maximum number of freed nodes each ktl::list retains for reuse, before
+ * returning them to its allocator. Can be adjusted per-list at runtime.
+ */
+#ifndef KTL_LIST_NODE_CACHE_SIZE
+#define KTL_LIST_NODE_CACHE_SIZE 32
+#endif
+
+/*
+ * Collect per-lock contention statistics (acquisitions, contentions, spin
+ * iterations, wait & hold time) for ktl::spin_lock & ktl::queued_spin_lock.
+ */
+#ifndef KTL_LOCK_STATISTICS
+#define KTL_LOCK_STATISTICS 0
+#endif
+
+/*
+ * Sample the probe length of one in this many ktl::flat_map::find calls, for
+ * flat_map::stats(). 0 compiles the sampling out.
+ */
+#ifndef KTL_MAP_PROBE_SAMPLE_RATE
+#define KTL_MAP_PROBE_SAMPLE_RATE 0
+#endif
+
+/*
+ * Target size in bytes of ktl::btree_map nodes, rounded up to a multiple of
+ * the cache line size. Larger nodes make the tree shallower, at the cost of
+ * more keys to scan in each node.
+ */
+#ifndef KTL_BTREE_NODE_SIZE
+#define KTL_BTREE_NODE_SIZE 256
+#endif
\ No newline at end of file
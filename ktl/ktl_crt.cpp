@@ -1,5 +1,6 @@
 #include "ktl_core.h"
 #include "ktl_crt.h"
+#include "type_traits"
 
 #include <new>
 
@@ -154,6 +155,9 @@ namespace ktl
 
 		InitializeListHead(&at_exit_fn_list__);
 
+		// Before any dynamic initializer can build a seeded table.
+		initialize_hash_secret();
+
 		__try
 		{
 			// Call all C dynamic initializers
@@ -6,7 +6,8 @@ namespace ktl
 	/// <summary>
 	/// We don't have a typical CRT in Kernel Mode. As such, we need to take manual control over
 	/// dynamic initialization. This method must be called at the very start of the DriverEntry
-	/// routine to ensure all dynamic globals are correctly constructed.
+	/// routine to ensure all dynamic globals are correctly constructed. It also generates the
+	/// secret used by seeded hashes (see ktl::initialize_hash_secret).
 	/// This method is not thread safe.
 	/// Even if you call this method, you'll need to ignore linker warning LNK4210, else to avoid:
 	/// warning LNK4210: .CRT section exists; there may be unhandled static initializers or terminators
@@ -0,0 +1,266 @@
+#pragma once
+
+#include "ktl_core.h"
+#include "algorithm"
+#include "memory"
+#include "type_traits"
+
+#include <emmintrin.h>
+
+namespace ktl
+{
+	/// <summary>
+	/// Search layout of a frozen sorted container.
+	/// </summary>
+	enum class sorted_layout
+	{
+		/// <summary>
+		/// Branchless binary search directly over the sorted keys.
+		/// </summary>
+		sorted,
+
+		/// <summary>
+		/// Additionally keep a copy of the keys in breadth-first (Eytzinger) order. Each search
+		/// step then reads the next level of the tree from a predictable place, which can be
+		/// prefetched several levels ahead. Worth the extra memory for large tables which are
+		/// searched far more often than they're built. Only used for trivially copyable keys.
+		/// </summary>
+		eytzinger,
+	};
+
+	namespace internal
+	{
+		[[nodiscard]] inline unsigned long trailing_zeros(size_t value)
+		{
+			unsigned long index = 0;
+
+#if defined(_M_X64) || defined(_M_ARM64)
+			BitScanForward64(&index, value);
+#else
+			BitScanForward(&index, value);
+#endif
+
+			return index;
+		}
+
+		/// <summary>
+		/// Keys of a sorted array laid out as an implicit binary search tree in breadth-first
+		/// order (node k has children 2k and 2k + 1), along with the sorted rank of each node.
+		/// </summary>
+		template<class K, class allocator_type>
+		struct eytzinger_index
+		{
+			static_assert(is_trivially_copyable_v<K>, "eytzinger_index copies keys byte-wise");
+
+			eytzinger_index() :
+				a_{ allocator_type::instance() }
+			{
+			}
+
+			eytzinger_index(const eytzinger_index&) = delete;
+			eytzinger_index& operator=(const eytzinger_index&) = delete;
+
+			~eytzinger_index()
+			{
+				reset();
+			}
+
+			explicit operator bool() const
+			{
+				return keys_ != nullptr;
+			}
+
+			[[nodiscard]] bool build(const K* sorted, size_t size)
+			{
+				reset();
+
+				if (size == 0)
+					return true;
+
+				// Both arrays are 1-based, so the root is at 1.
+				auto keys = static_cast<K*>(a_.allocate(sizeof(K) * (size + 1)));
+				if (!keys)
+					return false;
+
+				auto ranks = static_cast<size_t*>(a_.allocate(sizeof(size_t) * (size + 1)));
+				if (!ranks)
+				{
+					a_.deallocate(keys);
+					return false;
+				}
+
+				keys_ = keys;
+				ranks_ = ranks;
+				size_ = size;
+
+				size_t next = 0;
+				fill(sorted, next, 1);
+
+				return true;
+			}
+
+			void reset()
+			{
+				if (keys_)
+					a_.deallocate(keys_);
+
+				if (ranks_)
+					a_.deallocate(ranks_);
+
+				keys_ = nullptr;
+				ranks_ = nullptr;
+				size_ = 0;
+			}
+
+			/// <summary>
+			/// Find the sorted rank of the first key which is not less than key.
+			/// </summary>
+			/// <returns>rank in [0, size], where size means every key is less.</returns>
+			template<class Key, class Compare>
+			[[nodiscard]] size_t lower_bound(const Key& key, Compare& comp) const
+			{
+				// With a cache line of keys per prefetch, fetch the descendants this many levels down.
+				constexpr size_t PrefetchStride = sizeof(K) <= SYSTEM_CACHE_ALIGNMENT_SIZE ? SYSTEM_CACHE_ALIGNMENT_SIZE / sizeof(K) : 0;
+
+				size_t k = 1;
+
+				while (k <= size_)
+				{
+					if constexpr (PrefetchStride > 1)
+						_mm_prefetch(reinterpret_cast<const char*>(keys_ + k * PrefetchStride), _MM_HINT_T0);
+
+					k = 2 * k + static_cast<size_t>(comp(keys_[k], key));
+				}
+
+				// The path went right at every level below the answer: strip those right turns,
+				// and the final left turn, to get back to it.
+				k >>= trailing_zeros(~k) + 1;
+
+				return k ? ranks_[k] : size_;
+			}
+
+		private:
+			void fill(const K* sorted, size_t& next, size_t k)
+			{
+				// In-order walk of the implicit tree; recursion depth is log2(size).
+				if (k > size_)
+					return;
+
+				fill(sorted, next, 2 * k);
+
+				memcpy(keys_ + k, sorted + next, sizeof(K));
+				ranks_[k] = next++;
+
+				fill(sorted, next, 2 * k + 1);
+			}
+
+		private:
+			K* keys_ = nullptr;
+			size_t* ranks_ = nullptr;
+			size_t size_ = 0;
+			allocator_type& a_;
+		};
+
+		/// <summary>
+		/// Search index over the sorted keys of a frozen container.
+		/// </summary>
+		template<class K, class Compare, class allocator_type>
+		struct sorted_search
+		{
+			[[nodiscard]] bool build(const K* sorted, size_t size, sorted_layout layout)
+			{
+				if constexpr (is_trivially_copyable_v<K>)
+				{
+					if (layout == sorted_layout::eytzinger)
+						return eytzinger_.build(sorted, size);
+
+					eytzinger_.reset();
+				}
+
+				return true;
+			}
+
+			void reset()
+			{
+				if constexpr (is_trivially_copyable_v<K>)
+					eytzinger_.reset();
+			}
+
+			[[nodiscard]] sorted_layout layout() const
+			{
+				if constexpr (is_trivially_copyable_v<K>)
+				{
+					if (eytzinger_)
+						return sorted_layout::eytzinger;
+				}
+
+				return sorted_layout::sorted;
+			}
+
+			template<class Key>
+			[[nodiscard]] size_t lower_bound(const K* sorted, size_t size, const Key& key, Compare& comp) const
+			{
+				if constexpr (is_trivially_copyable_v<K>)
+				{
+					if (eytzinger_)
+						return eytzinger_.lower_bound(key, comp);
+				}
+
+				return static_cast<size_t>(internal::lower_bound(sorted, sorted + size, key, comp) - sorted);
+			}
+
+			template<class Key>
+			[[nodiscard]] size_t upper_bound(const K* sorted, size_t size, const Key& key, Compare& comp) const
+			{
+				return static_cast<size_t>(internal::upper_bound(sorted, sorted + size, key, comp) - sorted);
+			}
+
+		private:
+			struct no_index
+			{
+			};
+
+			conditional_t<is_trivially_copyable_v<K>, eytzinger_index<K, allocator_type>, no_index> eytzinger_;
+		};
+
+		/// <summary>
+		/// Check whether keys are strictly increasing, in which case freezing has nothing to sort.
+		/// </summary>
+		template<class K, class Compare>
+		[[nodiscard]] bool is_strictly_sorted(const K* keys, size_t size, Compare& comp)
+		{
+			for (size_t i = 1; i < size; ++i)
+			{
+				if (!comp(keys[i - 1], keys[i]))
+					return false;
+			}
+
+			return true;
+		}
+	}
+
+	/// <summary>
+	/// Half-open range of a sorted container, usable in range-based for.
+	/// </summary>
+	template<class iterator>
+	struct sorted_range
+	{
+		[[nodiscard]] iterator begin() const
+		{
+			return First;
+		}
+
+		[[nodiscard]] iterator end() const
+		{
+			return Last;
+		}
+
+		[[nodiscard]] bool empty() const
+		{
+			return First == Last;
+		}
+
+		iterator First;
+		iterator Last;
+	};
+}
\ No newline at end of file
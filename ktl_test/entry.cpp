@@ -1,6 +1,8 @@
 #include "ktl_test.h"
 #include "test.h"
 
+#include <ntintsafe.h>
+
 #include <ktl_core.h>
 #include <kernel>
 #include <memory>
@@ -15,6 +17,7 @@ extern "C"
     DRIVER_INITIALIZE DriverEntry;
     EVT_WDF_DEVICE_FILE_CREATE KtlTestCreate;
     EVT_WDF_FILE_CLOSE KtlTestClose;
+    EVT_WDF_FILE_CLEANUP KtlTestCleanup;
     EVT_WDF_IO_QUEUE_IO_DEVICE_CONTROL KtlTestFileIoDeviceControl;
     EVT_WDF_IO_IN_CALLER_CONTEXT KtlTestDeviceIoInCallerContext;
     EVT_WDF_DEVICE_SHUTDOWN_NOTIFICATION KtlTestDriverShutdown;
@@ -26,6 +29,7 @@ extern "C"
 #pragma alloc_text( INIT, DriverEntry )
 #pragma alloc_text( PAGE, KtlTestCreate )
 #pragma alloc_text( PAGE, KtlTestClose )
+#pragma alloc_text( PAGE, KtlTestCleanup )
 #pragma alloc_text( PAGE, KtlTestDriverShutdown )
 #pragma alloc_text( PAGE, KtlTestDriverUnload )
 #pragma alloc_text( PAGE, KtlTestDriverContextCleanup )
@@ -33,6 +37,147 @@ extern "C"
 
 static auto State = ktl::make_unique<KtlGlobalState>(ktl::pool_type::NonPaged);
 
+// Requests are handled in batches of this many records, copied out of the shared ring onto the stack.
+constexpr ULONG KtlTestRingBatch = 16;
+
+static NTSTATUS
+KtlTestRingRegister(
+    IN WDFREQUEST Request
+)
+{
+    PVOID buffer;
+    size_t length;
+    NTSTATUS status = WdfRequestRetrieveUnsafeUserInputBuffer(Request, sizeof(KTL_RING_REGION), &buffer, &length);
+    if (!NT_SUCCESS(status))
+        return status;
+
+    if (length > MAXULONG)
+        return STATUS_INVALID_BUFFER_SIZE;
+
+    if (!KtlRingValidBuffer(buffer))
+        return STATUS_DATATYPE_MISALIGNMENT;
+
+    // Locking the pages must happen in the caller's process, so this runs from the in-caller-context handler.
+    auto mapped = ktl::make_unique<ktl::safe_user_buffer>(ktl::pool_type::NonPaged, static_cast<PCHAR>(buffer), static_cast<ULONG>(length), IoWriteAccess);
+    if (!mapped)
+        return STATUS_INSUFFICIENT_RESOURCES;
+
+    if (!*mapped)
+        return STATUS_INVALID_USER_BUFFER;
+
+    auto region = static_cast<PKTL_RING_REGION>(mapped->get());
+
+    ULONG capacity;
+    if (!KtlRingValidate(region, length, capacity))
+        return STATUS_INVALID_PARAMETER;
+
+    // Don't rely on the shared header alone to keep the rings inside the locked pages.
+    SIZE_T records;
+    SIZE_T required;
+    if (!NT_SUCCESS(RtlSIZETMult(capacity, 2 * sizeof(KTL_RING_RECORD), &records)) ||
+        !NT_SUCCESS(RtlSIZETAdd(records, sizeof(KTL_RING_REGION), &required)) ||
+        required > length)
+    {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    ktl::scoped_lock lock{ State->RwLock };
+
+    auto& ring = State->Ring;
+    if (ring.Buffer)
+        return STATUS_DEVICE_BUSY;
+
+    if (!ring.Requests.attach(&region->Requests, KtlRingRequests(region), capacity) ||
+        !ring.Responses.attach(&region->Responses, KtlRingResponses(region, capacity), capacity))
+    {
+        ring.Requests = {};
+        ring.Responses = {};
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    ring.Buffer = ktl::move(mapped);
+    ring.Owner = WdfRequestGetFileObject(Request);
+    ring.Capacity = capacity;
+
+    return STATUS_SUCCESS;
+}
+
+static NTSTATUS
+KtlTestRingUnregister(
+    IN WDFFILEOBJECT FileObject
+)
+{
+    ktl::scoped_lock lock{ State->RwLock };
+
+    auto& ring = State->Ring;
+    if (!ring.Buffer || ring.Owner != FileObject)
+        return STATUS_NOT_FOUND;
+
+    ring.Requests = {};
+    ring.Responses = {};
+    ring.Capacity = 0;
+    ring.Owner = nullptr;
+    ring.Buffer.reset();
+
+    return STATUS_SUCCESS;
+}
+
+static void
+KtlTestRingHandle(
+    IN OUT KTL_RING_RECORD& record
+)
+{
+    switch (record.Operation)
+    {
+    case KTL_RING_OP_ECHO:
+        record.Status = record.Length <= KTL_RING_PAYLOAD_SIZE ? STATUS_SUCCESS : STATUS_INVALID_PARAMETER;
+        break;
+    default:
+        record.Status = STATUS_NOT_SUPPORTED;
+        break;
+    }
+}
+
+static NTSTATUS
+KtlTestRingKick(
+    IN WDFFILEOBJECT FileObject,
+    OUT ULONG& Handled
+)
+{
+    Handled = 0;
+
+    ktl::scoped_lock lock{ State->RwLock };
+
+    auto& ring = State->Ring;
+    if (!ring.Buffer || ring.Owner != FileObject)
+        return STATUS_INVALID_DEVICE_STATE;
+
+    // Handle at most one ring's worth per kick, so a caller which keeps producing can't hold us here forever.
+    KTL_RING_RECORD batch[KtlTestRingBatch];
+    while (Handled < ring.Capacity)
+    {
+        ULONG count = ring.Responses.available();
+        if (count > KtlTestRingBatch)
+            count = KtlTestRingBatch;
+
+        count = ring.Requests.pop(batch, count);
+        if (count == 0)
+            break;
+
+        for (ULONG i = 0; i < count; ++i)
+            KtlTestRingHandle(batch[i]);
+
+        // There was room for the whole batch, and only we produce responses.
+        ring.Responses.push(batch, count);
+        Handled += count;
+    }
+
+    if (ring.Requests.broken() || ring.Responses.broken())
+        return STATUS_DATA_ERROR;
+
+    return STATUS_SUCCESS;
+}
+
 NTSTATUS
 DriverEntry(
     IN OUT PDRIVER_OBJECT   DriverObject,
@@ -86,7 +231,7 @@ DriverEntry(
     init.set_exclusive_access(false);
     init.set_io_type(WdfDeviceIoBuffered);
     init.set_shutdown_handler(KtlTestDriverShutdown);
-    init.set_file_object_config(KtlTestCreate, KtlTestClose);
+    init.set_file_object_config(KtlTestCreate, KtlTestClose, KtlTestCleanup);
     init.set_device_io_in_caller_context_handler(KtlTestDeviceIoInCallerContext);
 
     WDFDEVICE controlDevice;
@@ -151,6 +296,20 @@ KtlTestClose(
     return;
 }
 
+VOID
+KtlTestCleanup(
+    IN WDFFILEOBJECT FileObject
+)
+{
+    PAGED_CODE();
+
+    // Cleanup runs in the process which closed the last handle, before its address space goes away, so a ring
+    // left registered by this handle is unlocked there.
+    (void)KtlTestRingUnregister(FileObject);
+
+    return;
+}
+
 VOID
 KtlTestFileIoDeviceControl(
     IN WDFQUEUE         Queue,
@@ -171,6 +330,8 @@ KtlTestFileIoDeviceControl(
     switch (IoControlCode)
     {
     case IOCTL_KTLTEST_METHOD_ALGORITHM_TEST:
+        if (!test_algorithm())
+            status = STATUS_FAIL_CHECK;
         break;
     case IOCTL_KTLTEST_METHOD_LIST_TEST:
         if (!test_list())
@@ -214,6 +375,69 @@ KtlTestFileIoDeviceControl(
     case IOCTL_KTLTEST_METHOD_MAP_TEST:
         if (!test_map())
             status = STATUS_FAIL_CHECK;
+        break;
+    case IOCTL_KTLTEST_METHOD_RCU_TEST:
+        if (!test_rcu())
+            status = STATUS_FAIL_CHECK;
+        break;
+    case IOCTL_KTLTEST_METHOD_THREAD_POOL_TEST:
+        if (!test_thread_pool())
+            status = STATUS_FAIL_CHECK;
+        break;
+    case IOCTL_KTLTEST_METHOD_SORTED_FLAT_MAP_TEST:
+        if (!test_sorted_flat_map())
+            status = STATUS_FAIL_CHECK;
+        break;
+    case IOCTL_KTLTEST_METHOD_BTREE_MAP_TEST:
+        if (!test_btree_map())
+            status = STATUS_FAIL_CHECK;
+        break;
+    case IOCTL_KTLTEST_METHOD_PATH_TRIE_TEST:
+        if (!test_path_trie())
+            status = STATUS_FAIL_CHECK;
+        break;
+    case IOCTL_KTLTEST_METHOD_MULTI_PATTERN_MATCHER_TEST:
+        if (!test_multi_pattern_matcher())
+            status = STATUS_FAIL_CHECK;
+        break;
+    case IOCTL_KTLTEST_METHOD_GLOB_TEST:
+        if (!test_glob())
+            status = STATUS_FAIL_CHECK;
+        break;
+    case IOCTL_KTLTEST_METHOD_BLOOM_FILTER_TEST:
+        if (!test_bloom_filter())
+            status = STATUS_FAIL_CHECK;
+        break;
+    case IOCTL_KTLTEST_METHOD_LRU_CACHE_TEST:
+        if (!test_lru_cache())
+            status = STATUS_FAIL_CHECK;
+        break;
+    case IOCTL_KTLTEST_METHOD_TIMER_WHEEL_TEST:
+        if (!test_timer_wheel())
+            status = STATUS_FAIL_CHECK;
+        break;
+    case IOCTL_KTLTEST_METHOD_FROZEN_TEST:
+        if (!test_frozen())
+            status = STATUS_FAIL_CHECK;
+        break;
+    case IOCTL_KTLTEST_METHOD_MUTEX_TEST:
+        if (!test_mutex())
+            status = STATUS_FAIL_CHECK;
+        break;
+    case IOCTL_KTLTEST_METHOD_SHARED_MUTEX_TEST:
+        if (!test_shared_mutex())
+            status = STATUS_FAIL_CHECK;
+        break;
+    case IOCTL_KTLTEST_RING_KICK:
+    {
+        ULONG handled;
+        status = KtlTestRingKick(WdfRequestGetFileObject(Request), handled);
+        request.set_information(handled);
+        break;
+    }
+    case IOCTL_KTLTEST_RING_UNREGISTER:
+        status = KtlTestRingUnregister(WdfRequestGetFileObject(Request));
+        break;
     default:
         break;
     }
@@ -236,6 +460,13 @@ KtlTestDeviceIoInCallerContext(
     auto params = request.params();
     if (params.Type == WdfRequestTypeDeviceControl)
     {
+        // Except ring registration, which locks the user's pages and so must complete here.
+        if (params.Parameters.DeviceIoControl.IoControlCode == IOCTL_KTLTEST_RING_REGISTER)
+        {
+            status = KtlTestRingRegister(Request);
+            return;
+        }
+
         request.forward(Device);
         return;
     }
@@ -3,7 +3,9 @@
 #include "common.h"
 
 #include <ktl_shared.h>
+#include <ktl_ring.h>
 
+#include <kernel>
 #include <memory>
 #include <shared_mutex>
 #include <string>
@@ -12,10 +14,23 @@
 // GUID generated by VS, hopefully actually globally unique.
 constexpr const ktl::unicode_string_view KTL_TEST_DEVICE_NAME{ L"\\DosDevices\\" KTL_TEST_DEVICE_USERMODE_NAME };
 
+// A user buffer registered with IOCTL_KTLTEST_RING_REGISTER, locked & mapped into system space.
+struct KtlRingState
+{
+    ktl::unique_ptr<ktl::safe_user_buffer> Buffer;
+    WDFFILEOBJECT Owner = nullptr;
+    ULONG Capacity = 0;
+    KtlRingConsumer Requests;
+    KtlRingProducer Responses;
+};
+
 struct KtlGlobalState
 {
     ktl::wdf_io_queue DefaultQueue;
     ktl::shared_mutex RwLock;
+
+    // Guarded by RwLock.
+    KtlRingState Ring;
 };
 
 typedef struct _KTL_TEST_IOCTL_CONTEXT
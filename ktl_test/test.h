@@ -33,6 +33,66 @@ bool test_map();
 bool test_memory();
 bool test_optional();
 bool test_tuple();
+bool test_rcu();
+bool test_thread_pool();
+bool test_algorithm();
+bool test_sorted_flat_map();
+bool test_btree_map();
+bool test_path_trie();
+bool test_multi_pattern_matcher();
+bool test_glob();
+bool test_bloom_filter();
+bool test_lru_cache();
+bool test_timer_wheel();
+bool test_frozen();
+bool test_mutex();
+bool test_shared_mutex();
+
+/// <summary>
+/// Runs a callable on a system thread, for tests which need a second thread to contend on a lock.
+/// The callable must outlive the thread, and join() must be called at PASSIVE_LEVEL.
+/// </summary>
+template<class F>
+struct test_thread
+{
+	explicit test_thread(F& f) :
+		f_(f)
+	{
+	}
+
+	test_thread(const test_thread&) = delete;
+	test_thread& operator=(const test_thread&) = delete;
+
+	~test_thread()
+	{
+		join();
+	}
+
+	[[nodiscard]] NTSTATUS start()
+	{
+		return PsCreateSystemThread(&thread_, THREAD_ALL_ACCESS, nullptr, nullptr, nullptr, &test_thread::thread_main, this);
+	}
+
+	void join()
+	{
+		if (!thread_)
+			return;
+
+		ZwWaitForSingleObject(thread_, FALSE, nullptr);
+		ZwClose(thread_);
+		thread_ = nullptr;
+	}
+
+private:
+	static void thread_main(PVOID context)
+	{
+		static_cast<test_thread*>(context)->f_();
+		PsTerminateSystemThread(STATUS_SUCCESS);
+	}
+
+	F& f_;
+	HANDLE thread_ = nullptr;
+};
 
 struct timer
 {
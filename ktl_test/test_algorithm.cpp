@@ -0,0 +1,251 @@
+#include "test.h"
+
+#include <algorithm>
+#include <execution>
+#include <thread_pool>
+
+struct keyed_value
+{
+	int Key;
+	int Order;
+};
+
+ULONG next_random(ULONG& state)
+{
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
+
+bool fill_random(ktl::vector<int>& v, size_t count, ULONG seed, ULONG range)
+{
+	v.clear();
+
+	if (!v.reserve(count))
+		return false;
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		int value = static_cast<int>(next_random(seed) % range) - static_cast<int>(range / 2);
+		if (!v.push_back(value))
+			return false;
+	}
+
+	return true;
+}
+
+template<typename T, typename Compare = ktl::less<>>
+bool is_sorted(const T* first, const T* last, Compare comp = {})
+{
+	for (auto it = first; it + 1 < last; ++it)
+	{
+		if (comp(*(it + 1), *it))
+			return false;
+	}
+
+	return true;
+}
+
+bool test_algorithm_sort()
+{
+	ktl::vector<int> v;
+
+	// Random, few unique values, sorted, and reversed inputs exercise the different pdqsort paths.
+	ASSERT_TRUE(fill_random(v, 10000, 0x12345678, 0x7FFFFFFF), "failed to fill vector");
+	ktl::sort(v);
+	ASSERT_TRUE(is_sorted(v.data(), v.data() + v.size()), "random input was not sorted");
+
+	ASSERT_TRUE(fill_random(v, 10000, 0x9E3779B9, 4), "failed to fill vector");
+	ktl::sort(v);
+	ASSERT_TRUE(is_sorted(v.data(), v.data() + v.size()), "input with duplicates was not sorted");
+
+	ktl::sort(v);
+	ASSERT_TRUE(is_sorted(v.data(), v.data() + v.size()), "sorted input was not sorted");
+
+	ktl::sort(v, [](int a, int b) { return a > b; });
+	ASSERT_TRUE(is_sorted(v.data(), v.data() + v.size(), [](int a, int b) { return a > b; }), "input was not sorted in descending order");
+
+	ktl::sort(v);
+	ASSERT_TRUE(is_sorted(v.data(), v.data() + v.size()), "reversed input was not sorted");
+
+	ktl::vector<int> empty;
+	ktl::sort(empty);
+
+	return true;
+}
+
+bool test_algorithm_stable_sort()
+{
+	ktl::vector<keyed_value> v;
+	ULONG seed = 0xC0FFEE;
+
+	for (int i = 0; i < 5000; ++i)
+		ASSERT_TRUE(v.push_back({ static_cast<int>(next_random(seed) % 16), i }), "failed to fill vector");
+
+	auto byKey = [](const keyed_value& a, const keyed_value& b) { return a.Key < b.Key; };
+	ktl::stable_sort(v, byKey);
+
+	for (size_t i = 1; i < v.size(); ++i)
+	{
+		ASSERT_TRUE(v[i - 1].Key <= v[i].Key, "stable_sort output was not sorted at %llu", static_cast<ULONG64>(i));
+
+		if (v[i - 1].Key == v[i].Key)
+			ASSERT_TRUE(v[i - 1].Order < v[i].Order, "stable_sort reordered equal elements at %llu", static_cast<ULONG64>(i));
+	}
+
+	return true;
+}
+
+bool test_algorithm_radix_sort()
+{
+	ktl::vector<int> v;
+	ASSERT_TRUE(fill_random(v, 10000, 0xDEADBEEF, 0x7FFFFFFF), "failed to fill vector");
+
+	ASSERT_TRUE(ktl::radix_sort(v), "radix_sort failed");
+	ASSERT_TRUE(is_sorted(v.data(), v.data() + v.size()), "radix_sort didn't sort signed keys");
+
+	ktl::vector<keyed_value> keyed;
+	ULONG seed = 0xABCDEF;
+
+	for (int i = 0; i < 5000; ++i)
+		ASSERT_TRUE(keyed.push_back({ static_cast<int>(next_random(seed) % 300), i }), "failed to fill vector");
+
+	ASSERT_TRUE(ktl::radix_sort(keyed, [](const keyed_value& value) { return static_cast<unsigned short>(value.Key); }), "radix_sort with key failed");
+
+	for (size_t i = 1; i < keyed.size(); ++i)
+	{
+		ASSERT_TRUE(keyed[i - 1].Key <= keyed[i].Key, "radix_sort output was not sorted at %llu", static_cast<ULONG64>(i));
+
+		if (keyed[i - 1].Key == keyed[i].Key)
+			ASSERT_TRUE(keyed[i - 1].Order < keyed[i].Order, "radix_sort reordered equal elements at %llu", static_cast<ULONG64>(i));
+	}
+
+	return true;
+}
+
+bool test_algorithm_select_and_search()
+{
+	ktl::vector<int> v;
+	ASSERT_TRUE(fill_random(v, 1001, 0x600DF00D, 1000), "failed to fill vector");
+
+	ktl::nth_element(v, 500);
+	int median = v[500];
+
+	for (size_t i = 0; i < 500; ++i)
+		ASSERT_TRUE(v[i] <= median, "element before nth was greater than it");
+
+	for (size_t i = 501; i < v.size(); ++i)
+		ASSERT_TRUE(v[i] >= median, "element after nth was less than it");
+
+	int values[] = { 1, 3, 3, 3, 5, 8 };
+	auto first = values;
+	auto last = values + ARRAYSIZE(values);
+
+	ASSERT_TRUE(ktl::lower_bound(first, last, 3) == values + 1, "lower_bound didn't find the first match");
+	ASSERT_TRUE(ktl::upper_bound(first, last, 3) == values + 4, "upper_bound didn't skip every match");
+	ASSERT_TRUE(ktl::lower_bound(first, last, 0) == first, "lower_bound of a key below the range wasn't first");
+	ASSERT_TRUE(ktl::lower_bound(first, last, 9) == last, "lower_bound of a key above the range wasn't last");
+	ASSERT_TRUE(ktl::upper_bound(first, last, 4) == values + 4, "upper_bound of a missing key was wrong");
+
+	return true;
+}
+
+bool test_algorithm_for_each()
+{
+	ktl::vector<int> v;
+
+	for (int i = 1; i <= 100; ++i)
+		ASSERT_TRUE(v.push_back(i), "failed to fill vector");
+
+	ktl::for_each(v, [](int& value) { value *= 2; });
+	ASSERT_TRUE(ktl::reduce(v, 0LL) == 10100, "unexpected sum after for_each");
+
+	long long squares[100];
+	ktl::transform(v, squares, [](int value) { return static_cast<long long>(value) * value; });
+	ASSERT_TRUE(squares[99] == 40000, "unexpected transform output: %lld", squares[99]);
+
+	int maximum = ktl::reduce(v.data(), v.data() + v.size(), 0, [](int a, int b) { return ktl::max(a, b); });
+	ASSERT_TRUE(maximum == 200, "unexpected maximum: %d", maximum);
+
+	return true;
+}
+
+bool test_algorithm_parallel(ktl::thread_pool& pool)
+{
+	auto policy = ktl::execution::par(pool, 1024);
+
+	ktl::vector<int> v;
+	ASSERT_TRUE(fill_random(v, 100000, 0x1234ABCD, 0x7FFFFFFF), "failed to fill vector");
+	ktl::sort(policy, v);
+	ASSERT_TRUE(is_sorted(v.data(), v.data() + v.size()), "parallel sort didn't sort random input");
+
+	ASSERT_TRUE(fill_random(v, 100000, 0x4321DCBA, 64), "failed to fill vector");
+	ktl::sort(policy, v);
+	ASSERT_TRUE(is_sorted(v.data(), v.data() + v.size()), "parallel sort didn't sort input with duplicates");
+
+	ASSERT_TRUE(fill_random(v, 100000, 0x0BADCAFE, 0x7FFFFFFF), "failed to fill vector");
+	ASSERT_TRUE(ktl::radix_sort(policy, v), "parallel radix_sort failed");
+	ASSERT_TRUE(is_sorted(v.data(), v.data() + v.size()), "parallel radix_sort didn't sort");
+
+	ktl::vector<keyed_value> keyed;
+	ULONG seed = 0xFEEDFACE;
+
+	for (int i = 0; i < 50000; ++i)
+		ASSERT_TRUE(keyed.push_back({ static_cast<int>(next_random(seed) % 100), i }), "failed to fill vector");
+
+	ktl::stable_sort(policy, keyed, [](const keyed_value& a, const keyed_value& b) { return a.Key < b.Key; });
+
+	for (size_t i = 1; i < keyed.size(); ++i)
+	{
+		ASSERT_TRUE(keyed[i - 1].Key <= keyed[i].Key, "parallel stable_sort output was not sorted at %llu", static_cast<ULONG64>(i));
+
+		if (keyed[i - 1].Key == keyed[i].Key)
+			ASSERT_TRUE(keyed[i - 1].Order < keyed[i].Order, "parallel stable_sort reordered equal elements at %llu", static_cast<ULONG64>(i));
+	}
+
+	v.clear();
+	for (int i = 0; i < 100000; ++i)
+		ASSERT_TRUE(v.push_back(1), "failed to fill vector");
+
+	ktl::for_each(policy, v, [](int& value) { value += 1; });
+	ASSERT_TRUE(ktl::reduce(policy, v, 0LL) == 200000, "unexpected parallel sum");
+	ASSERT_TRUE(ktl::reduce(ktl::execution::seq, v, 0LL) == 200000, "unexpected sequenced sum");
+
+	return true;
+}
+
+bool test_algorithm()
+{
+	__try
+	{
+		if (!test_algorithm_sort())
+			return false;
+
+		if (!test_algorithm_stable_sort())
+			return false;
+
+		if (!test_algorithm_radix_sort())
+			return false;
+
+		if (!test_algorithm_select_and_search())
+			return false;
+
+		if (!test_algorithm_for_each())
+			return false;
+
+		ktl::thread_pool pool;
+		ASSERT_TRUE(NT_SUCCESS(pool.start()), "failed to start thread pool");
+
+		if (!test_algorithm_parallel(pool))
+			return false;
+	}
+	__except (EXCEPTION_EXECUTE_HANDLER)
+	{
+		LOG_ERROR("[NG]: %#x\n", GetExceptionCode());
+		return false;
+	}
+
+	LOG_TRACE("[OK] ktl::algorithm!\n");
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,149 @@
+#include "test.h"
+
+#include <bloom_filter>
+#include <map>
+#include <set>
+#include <string>
+
+bool test_bloom_filter_basic()
+{
+	constexpr ULONG64 Count = 10000;
+
+	ktl::bloom_filter<ULONG64> filter;
+	ASSERT_TRUE(filter.may_contain(1), "unreserved bloom_filter rejected a key");
+	ASSERT_TRUE(filter.reserve(Count), "failed to reserve bloom_filter");
+	ASSERT_TRUE(filter.byte_size() == filter.block_count() * 64, "unexpected bloom_filter size: %llu", filter.byte_size());
+
+	for (ULONG64 i = 0; i < Count; ++i)
+		filter.insert(i * 7919);
+
+	for (ULONG64 i = 0; i < Count; ++i)
+		ASSERT_TRUE(filter.may_contain(i * 7919), "bloom_filter rejected inserted key %llu", i * 7919);
+
+	// About 1% at 10 bits per key; allow plenty of slack.
+	size_t falsePositives = 0;
+	for (ULONG64 i = 0; i < Count; ++i)
+	{
+		if (filter.may_contain(i * 7919 + 1))
+			++falsePositives;
+	}
+
+	ASSERT_TRUE(falsePositives < Count / 30, "bloom_filter false positive rate too high: %llu", falsePositives);
+
+	filter.clear();
+	ASSERT_FALSE(filter.may_contain(7919), "cleared bloom_filter kept a key");
+
+	return true;
+}
+
+bool test_bloom_filter_strings()
+{
+	ktl::bloom_filter<ktl::unicode_string<>> filter;
+	ASSERT_TRUE(filter.reserve(16), "failed to reserve bloom_filter");
+
+	filter.insert(ktl::unicode_string<>{ L"\\Device\\HarddiskVolume1" });
+
+	// Views hash the same way as strings.
+	ASSERT_TRUE(filter.may_contain_hash(ktl::hash<ktl::unicode_string_view>{}(L"\\Device\\HarddiskVolume1")), "bloom_filter rejected a view of an inserted string");
+
+	return true;
+}
+
+bool test_xor_filter()
+{
+	ktl::vector<ULONG64, ktl::paged_pool_allocator> keys;
+
+	for (ULONG64 i = 0; i < 10000; ++i)
+		ASSERT_TRUE(keys.push_back(i * i), "failed to add key");
+
+	// Repeated keys are ignored.
+	ASSERT_TRUE(keys.push_back(4), "failed to add key");
+
+	ktl::xor_filter<ULONG64> filter;
+	ASSERT_TRUE(filter.may_contain(1), "unbuilt xor_filter rejected a key");
+	ASSERT_TRUE(filter.build(keys), "failed to build xor_filter");
+	ASSERT_TRUE(filter.size() == 10000, "unexpected xor_filter size: %llu", filter.size());
+
+	for (ULONG64 i = 0; i < 10000; ++i)
+		ASSERT_TRUE(filter.may_contain(i * i), "xor_filter rejected key %llu", i * i);
+
+	// About 0.4%.
+	size_t falsePositives = 0;
+	for (ULONG64 i = 1; i <= 10000; ++i)
+	{
+		if (filter.may_contain(i * i + 1))
+			++falsePositives;
+	}
+
+	ASSERT_TRUE(falsePositives < 100, "xor_filter false positive rate too high: %llu", falsePositives);
+
+	ktl::xor_filter<ULONG64> empty;
+	ASSERT_TRUE(empty.build(static_cast<const ULONG64*>(nullptr), 0), "failed to build empty xor_filter");
+	ASSERT_FALSE(empty.may_contain(0), "empty xor_filter matched a key");
+
+	return true;
+}
+
+bool test_prefiltered()
+{
+	ktl::prefiltered<ULONG64, ktl::unordered_set<ULONG64>> set;
+	ASSERT_TRUE(set.reserve(1000), "failed to reserve prefiltered set");
+
+	for (ULONG64 i = 0; i < 1000; ++i)
+		ASSERT_TRUE(set.insert(i * 3), "failed to insert into prefiltered set");
+
+	ASSERT_FALSE(set.reserve(1000), "reserved prefiltered set while it held keys");
+	ASSERT_TRUE(set.size() == 1000, "unexpected prefiltered set size: %llu", set.size());
+
+	for (ULONG64 i = 0; i < 3000; ++i)
+		ASSERT_TRUE(set.contains(i) == (i % 3 == 0), "prefiltered set lookup of %llu was wrong", i);
+
+	const auto& constSet = set;
+	ASSERT_TRUE(constSet.contains(3) && !constSet.contains(4), "const prefiltered set lookup was wrong");
+
+	ktl::prefiltered<int, ktl::flat_map<int, int>> map;
+	ASSERT_TRUE(map.reserve(100), "failed to reserve prefiltered map");
+
+	for (int i = 0; i < 100; ++i)
+		ASSERT_TRUE(map.insert(i, i * 2) != map.container().end(), "failed to insert into prefiltered map");
+
+	auto it = map.find(42);
+	ASSERT_TRUE(it != map.container().end(), "failed to find key in prefiltered map");
+
+	auto [key, value] = *it;
+	ASSERT_TRUE(key == 42 && value == 84, "unexpected value in prefiltered map");
+
+	ASSERT_TRUE(map.find(1000) == map.container().end(), "found absent key in prefiltered map");
+	ASSERT_TRUE(map.contains(99) && !map.contains(-1), "prefiltered map lookup was wrong");
+
+	(void)map.erase(42);
+	ASSERT_FALSE(map.contains(42), "found erased key in prefiltered map");
+
+	return true;
+}
+
+bool test_bloom_filter()
+{
+	__try
+	{
+		if (!test_bloom_filter_basic())
+			return false;
+
+		if (!test_bloom_filter_strings())
+			return false;
+
+		if (!test_xor_filter())
+			return false;
+
+		if (!test_prefiltered())
+			return false;
+	}
+	__except (EXCEPTION_EXECUTE_HANDLER)
+	{
+		LOG_ERROR("[NG]: %#x\n", GetExceptionCode());
+		return false;
+	}
+
+	LOG_TRACE("[OK] ktl::bloom_filter!\n");
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,237 @@
+#include "test.h"
+
+#include <btree_map>
+#include <string>
+
+template<class map_type>
+bool check_btree_map_order(const map_type& map)
+{
+	size_t count = 0;
+	bool first = true;
+	int previous = 0;
+
+	for (auto [key, value] : map)
+	{
+		ASSERT_TRUE(first || key > previous, "btree_map iteration was out of order");
+		ASSERT_TRUE(value == key * 3, "btree_map value %d didn't match key %d", value, key);
+
+		first = false;
+		previous = key;
+		++count;
+	}
+
+	ASSERT_TRUE(count == map.size(), "iteration visited %llu of %llu elements", count, map.size());
+	return true;
+}
+
+bool test_btree_map_insert_erase()
+{
+	ktl::btree_map<int, int> map;
+
+	ASSERT_TRUE(map.begin() == map.end(), "empty btree_map had elements");
+	ASSERT_FALSE(map.erase(1), "erased from an empty btree_map");
+
+	// Scatter the keys across the tree, so inserts split nodes all over it.
+	for (int i = 0; i < 5000; ++i)
+	{
+		int key = (i * 7919) % 5000;
+		ASSERT_TRUE(map.insert(key, key * 3) != map.end(), "failed to insert into btree_map");
+	}
+
+	ASSERT_TRUE(map.size() == 5000, "unexpected size after inserting: %llu", map.size());
+	ASSERT_TRUE(map.height() > 1, "btree_map didn't grow past a single leaf");
+
+	if (!check_btree_map_order(map))
+		return false;
+
+	// Replacing a value doesn't add an element.
+	auto it = map.insert(42, 0);
+	ASSERT_TRUE(it != map.end() && it.key() == 42 && it.value() == 0, "failed to replace value in btree_map");
+	ASSERT_TRUE(map.size() == 5000, "replacing a value changed the size");
+	it.value() = 42 * 3;
+
+	for (int i = 0; i < 5000; ++i)
+	{
+		auto found = map.find(i);
+		ASSERT_TRUE(found != map.end() && found.value() == i * 3, "failed to find key %d", i);
+	}
+
+	ASSERT_FALSE(map.contains(-1), "btree_map contained a key below the smallest key");
+	ASSERT_FALSE(map.contains(5000), "btree_map contained a key above the largest key");
+
+	// Erase every odd key, then most of the rest, so nodes borrow, merge and the root shrinks.
+	for (int i = 1; i < 5000; i += 2)
+		ASSERT_TRUE(map.erase(i), "failed to erase key %d", i);
+
+	ASSERT_FALSE(map.erase(1), "erased a key twice");
+	ASSERT_TRUE(map.size() == 2500, "unexpected size after erasing: %llu", map.size());
+
+	if (!check_btree_map_order(map))
+		return false;
+
+	for (int i = 0; i < 5000; ++i)
+		ASSERT_TRUE(map.contains(i) == (i % 2 == 0), "unexpected membership of key %d after erasing", i);
+
+	for (int i = 4998; i >= 10; i -= 2)
+		ASSERT_TRUE(map.erase(i), "failed to erase key %d", i);
+
+	ASSERT_TRUE(map.size() == 5, "unexpected size after erasing: %llu", map.size());
+	ASSERT_TRUE(map.height() == 1, "btree_map didn't shrink back to a single leaf");
+
+	if (!check_btree_map_order(map))
+		return false;
+
+	for (int i = 0; i < 10; i += 2)
+		ASSERT_TRUE(map.erase(i), "failed to erase key %d", i);
+
+	ASSERT_TRUE(map.empty() && map.begin() == map.end(), "btree_map wasn't empty after erasing everything");
+
+	ASSERT_TRUE(map.insert(1, 3) != map.end(), "failed to insert into emptied btree_map");
+	ASSERT_TRUE(map.contains(1), "key inserted into emptied btree_map wasn't found");
+
+	return true;
+}
+
+bool test_btree_map_bounds()
+{
+	ktl::btree_map<ULONG, int> map;
+
+	for (ULONG i = 0; i < 1000; ++i)
+		ASSERT_TRUE(map.insert(i * 2, static_cast<int>(i)) != map.end(), "failed to insert into btree_map");
+
+	for (ULONG i = 0; i < 1999; ++i)
+	{
+		auto lower = map.lower_bound(i);
+		ULONG expected = (i + 1) / 2 * 2;
+		ASSERT_TRUE(lower != map.end() && lower.key() == expected, "unexpected lower_bound for %lu", i);
+	}
+
+	ASSERT_TRUE(map.lower_bound(1999ul) == map.end(), "lower_bound above the largest key wasn't end");
+	ASSERT_TRUE(map.upper_bound(1998ul) == map.end(), "upper_bound of the largest key wasn't end");
+	ASSERT_TRUE(map.upper_bound(4ul).key() == 6, "unexpected upper_bound");
+
+	// Keys with the top bit set must still sort after the others.
+	ASSERT_TRUE(map.insert(0x80000000ul, -1) != map.end(), "failed to insert into btree_map");
+	ASSERT_TRUE(map.lower_bound(1999ul).key() == 0x80000000ul, "unsigned keys compared as signed");
+
+	size_t count = 0;
+	ULONG expected = 100;
+
+	for (auto [key, value] : map.range(100ul, 700ul))
+	{
+		ASSERT_TRUE(key == expected, "range returned key %lu, expected %lu", key, expected);
+		expected += 2;
+		++count;
+	}
+
+	ASSERT_TRUE(count == 300, "unexpected number of elements in range: %llu", count);
+	ASSERT_TRUE(map.range(700ul, 100ul).empty(), "inverted range wasn't empty");
+
+	const auto& constMap = map;
+	ASSERT_TRUE(constMap.find(10ul).value() == 5, "const find returned the wrong value");
+
+	return true;
+}
+
+bool test_btree_map_bulk_load()
+{
+	constexpr size_t Count = 10000;
+
+	ktl::vector<int, ktl::paged_pool_allocator> keys;
+	ktl::vector<int, ktl::paged_pool_allocator> values;
+
+	ASSERT_TRUE(keys.reserve(Count) && values.reserve(Count), "failed to reserve input");
+
+	for (size_t i = 0; i < Count; ++i)
+	{
+		(void)keys.push_back(static_cast<int>(i) * 2);
+		(void)values.push_back(static_cast<int>(i) * 6);
+	}
+
+	ktl::nonpaged_lookaside_btree_map<int, int> map;
+
+	ASSERT_TRUE(map.bulk_load(keys.data(), values.data(), Count), "failed to bulk load btree_map");
+	ASSERT_TRUE(map.size() == Count, "unexpected size after bulk load: %llu", map.size());
+	ASSERT_FALSE(map.bulk_load(keys.data(), values.data(), Count), "bulk loaded a btree_map which wasn't empty");
+
+	if (!check_btree_map_order(map))
+		return false;
+
+	// The bulk loaded tree must stay balanced through ordinary updates.
+	for (int i = 1; i < 4000; i += 2)
+		ASSERT_TRUE(map.insert(i, i * 3) != map.end(), "failed to insert into bulk loaded btree_map");
+
+	for (int i = 0; i < 8000; i += 4)
+		ASSERT_TRUE(map.erase(i), "failed to erase key %d from bulk loaded btree_map", i);
+
+	ASSERT_TRUE(map.size() == Count, "unexpected size after updates: %llu", map.size());
+
+	if (!check_btree_map_order(map))
+		return false;
+
+	ktl::btree_map<int, int> unsorted;
+	int reversed[] = { 3, 2, 1 };
+	ASSERT_FALSE(unsorted.bulk_load(reversed, reversed, 3), "bulk loaded unsorted keys");
+	ASSERT_TRUE(unsorted.empty(), "failed bulk load left elements behind");
+
+	return true;
+}
+
+void format_device_number(wchar_t (&buffer)[12], int number)
+{
+	buffer[8] = static_cast<wchar_t>(L'0' + number / 100);
+	buffer[9] = static_cast<wchar_t>(L'0' + number / 10 % 10);
+	buffer[10] = static_cast<wchar_t>(L'0' + number % 10);
+}
+
+bool test_btree_map_strings()
+{
+	ktl::btree_map<ktl::unicode_string<>, int> map;
+
+	for (int i = 0; i < 200; ++i)
+	{
+		wchar_t buffer[] = L"\\Device\\000";
+		format_device_number(buffer, i);
+		ASSERT_TRUE(map.insert(ktl::unicode_string<>{ buffer }, i) != map.end(), "failed to insert string into btree_map");
+	}
+
+	for (int i = 0; i < 200; i += 3)
+	{
+		wchar_t buffer[] = L"\\Device\\000";
+		format_device_number(buffer, i);
+		ASSERT_TRUE(map.erase(ktl::unicode_string_view{ static_cast<const wchar_t*>(buffer) }), "failed to erase string from btree_map");
+	}
+
+	auto it = map.find(ktl::unicode_string_view{ L"\\Device\\100" });
+	ASSERT_TRUE(it != map.end() && it.value() == 100, "failed to find string key");
+	ASSERT_FALSE(map.contains(ktl::unicode_string_view{ L"\\Device\\099" }), "found erased string key");
+	ASSERT_TRUE((*map.begin()).Value == 1, "smallest string key wasn't first");
+
+	return true;
+}
+
+bool test_btree_map()
+{
+	__try
+	{
+		if (!test_btree_map_insert_erase())
+			return false;
+
+		if (!test_btree_map_bounds())
+			return false;
+
+		if (!test_btree_map_bulk_load())
+			return false;
+
+		if (!test_btree_map_strings())
+			return false;
+	}
+	__except (EXCEPTION_EXECUTE_HANDLER)
+	{
+		LOG_ERROR("[NG]: %#x\n", GetExceptionCode());
+		return false;
+	}
+
+	LOG_TRACE("[OK] ktl::btree_map!\n");
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include "test.h"
+
+#include <frozen>
+#include <ktl_shared.h>
+
+namespace
+{
+	constexpr auto DeviceNames = ktl::make_frozen_set<ktl::unicode_string_view>({
+		L"\\Device\\Null",
+		L"\\Device\\Beep",
+		L"\\Device\\KsecDD",
+		L"\\Device\\Afd",
+		L"\\Device\\Tcp",
+		L"\\Device\\Udp",
+		L"\\Device\\HarddiskVolume1",
+		L"\\Device\\HarddiskVolume2",
+		L"\\Device\\NamedPipe",
+		L"\\Device\\Mailslot",
+		L"",
+	});
+
+	static_assert(DeviceNames.size() == 11);
+	static_assert(DeviceNames.contains(L"\\Device\\Afd"));
+	static_assert(DeviceNames.contains(L""));
+	static_assert(!DeviceNames.contains(L"\\Device\\afd"));
+	static_assert(!DeviceNames.contains(L"\\Device\\HarddiskVolume3"));
+
+	constexpr auto IoctlNames = ktl::make_frozen_map<ULONG, ktl::unicode_string_view>({
+		{ IOCTL_KTLTEST_METHOD_MEMORY_TEST, L"memory" },
+		{ IOCTL_KTLTEST_METHOD_VECTOR_TEST, L"vector" },
+		{ IOCTL_KTLTEST_METHOD_MAP_TEST, L"map" },
+		{ IOCTL_KTLTEST_METHOD_SET_TEST, L"set" },
+		{ IOCTL_KTLTEST_METHOD_FROZEN_TEST, L"frozen" },
+	});
+
+	static_assert(ktl::frozen_equal<ktl::unicode_string_view>{}(*IoctlNames.find(IOCTL_KTLTEST_METHOD_FROZEN_TEST), L"frozen"));
+	static_assert(IoctlNames.find(0) == nullptr);
+
+	struct squares
+	{
+		ULONG64 Values[512];
+	};
+
+	consteval squares make_squares()
+	{
+		squares result = {};
+		for (ULONG64 i = 0; i < 512; ++i)
+			result.Values[i] = i * i;
+
+		return result;
+	}
+
+	constexpr squares Squares = make_squares();
+	constexpr auto SquareSet = ktl::make_frozen_set(Squares.Values);
+
+	static_assert(SquareSet.contains(511 * 511));
+	static_assert(!SquareSet.contains(2));
+}
+
+bool test_frozen_set()
+{
+	for (const auto& name : DeviceNames)
+		ASSERT_TRUE(DeviceNames.find(name) == ktl::addressof(name), "failed to find frozen key %wZ", name.data());
+
+	// Lookups with keys that don't share storage with the literals.
+	WCHAR buffer[] = L"\\Device\\Tcp";
+	UNICODE_STRING name;
+	RtlInitUnicodeString(&name, buffer);
+	ASSERT_TRUE(DeviceNames.contains(&name), "failed to find frozen key from a runtime buffer");
+
+	buffer[9] = L'x';
+	ASSERT_FALSE(DeviceNames.contains(&name), "found a key which isn't in the frozen set");
+
+	name.Length = 7 * sizeof(WCHAR);
+	ASSERT_FALSE(DeviceNames.contains(&name), "found a prefix of a frozen key");
+
+	volatile ULONG64 limit = 512 * 512;
+	ULONG64 found = 0;
+	for (ULONG64 i = 0; i < limit; ++i)
+	{
+		if (SquareSet.contains(i))
+			++found;
+	}
+
+	ASSERT_TRUE(found == 512, "unexpected number of frozen squares: %llu", found);
+	ASSERT_FALSE(SquareSet.contains(~0ull), "found a key which isn't in the frozen set");
+
+	return true;
+}
+
+bool test_frozen_map()
+{
+	ASSERT_TRUE(IoctlNames.size() == 5, "unexpected frozen_map size: %llu", IoctlNames.size());
+
+	for (const auto& entry : IoctlNames)
+	{
+		auto value = IoctlNames.find(entry.Key);
+		ASSERT_TRUE(value == ktl::addressof(entry.Value), "failed to find frozen key %#x", entry.Key);
+	}
+
+	ULONG code = IOCTL_KTLTEST_METHOD_VECTOR_TEST;
+	ASSERT_TRUE(IoctlNames.value_or(code, L"") == L"vector", "unexpected frozen value");
+
+	code = ~code;
+	ASSERT_TRUE(IoctlNames.find(code) == nullptr, "found a key which isn't in the frozen map");
+	ASSERT_TRUE(IoctlNames.value_or(code, L"unknown") == L"unknown", "value_or didn't fall back");
+
+	return true;
+}
+
+bool test_frozen()
+{
+	__try
+	{
+		if (!test_frozen_set())
+			return false;
+
+		if (!test_frozen_map())
+			return false;
+	}
+	__except (EXCEPTION_EXECUTE_HANDLER)
+	{
+		LOG_ERROR("[NG]: %#x\n", GetExceptionCode());
+		return false;
+	}
+
+	LOG_TRACE("[OK] ktl::frozen_set & ktl::frozen_map!\n");
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,124 @@
+#include "test.h"
+
+#include <glob>
+
+struct glob_case
+{
+	const wchar_t* Pattern;
+	const wchar_t* Name;
+	bool Expected;
+};
+
+bool test_glob_pattern()
+{
+	const glob_case cases[] =
+	{
+		{ L"ntoskrnl.exe", L"ntoskrnl.exe", true },
+		{ L"ntoskrnl.exe", L"ntoskrnl.ex", false },
+		{ L"*", L"", true },
+		{ L"*", L"anything.at.all", true },
+		{ L"*.sys", L"disk.sys", true },
+		{ L"*.sys", L"disk.sys.bak", false },
+		{ L"*.sys", L".sys", true },
+		{ L"\\Device\\*", L"\\Device\\HarddiskVolume1", true },
+		{ L"\\Device\\*", L"\\Devices", false },
+		{ L"a*b*c", L"abc", true },
+		{ L"a*b*c", L"axxbyyc", true },
+		{ L"a*b*c", L"axxbyy", false },
+		{ L"a**c", L"ac", true },
+		{ L"???.txt", L"abc.txt", true },
+		{ L"???.txt", L"ab.txt", false },
+		{ L"*?x", L"x", false },
+		{ L"*?x", L"ax", true },
+
+		// < matches up to the final period.
+		{ L"<.txt", L"notes.txt", true },
+		{ L"<.txt", L"notes.old.txt", true },
+		{ L"<.txt", L"notes.txt.old", false },
+		{ L"<", L"noextension", true },
+
+		// > matches one character, or nothing at a period or the end of the name.
+		{ L"a>>.txt", L"a.txt", true },
+		{ L"a>>.txt", L"abc.txt", true },
+		{ L"a>>.txt", L"abcd.txt", false },
+		{ L"file>>>", L"file", true },
+		{ L"file>>>", L"file1", true },
+		{ L"file>>>", L"file1234", false },
+
+		// " matches a period, or nothing at the end of the name.
+		{ L"readme\"", L"readme", true },
+		{ L"readme\"", L"readme.", true },
+		{ L"readme\"", L"readmex", false },
+		{ L"<\"<", L"noextension", true },
+	};
+
+	for (const auto& c : cases)
+	{
+		ktl::glob_pattern<> pattern;
+		ASSERT_TRUE(pattern.compile(c.Pattern), "failed to compile glob_pattern");
+		ASSERT_TRUE(pattern.matches(c.Name) == c.Expected, "glob_pattern %ws matching %ws wasn't %d", c.Pattern, c.Name, c.Expected);
+	}
+
+	ktl::glob_pattern<> insensitive;
+	ASSERT_TRUE(insensitive.compile(L"*\\SYSTEM32\\<.DLL", true), "failed to compile glob_pattern");
+	ASSERT_TRUE(insensitive.matches(L"\\Windows\\System32\\ntdll.dll"), "case insensitive glob_pattern didn't fold case");
+	ASSERT_FALSE(insensitive.matches(L"\\Windows\\System32\\ntdll.exe"), "case insensitive glob_pattern matched the wrong extension");
+
+	ktl::glob_pattern<> uncompiled;
+	ASSERT_FALSE(uncompiled.matches(L""), "uncompiled glob_pattern matched");
+
+	return true;
+}
+
+bool test_glob_set()
+{
+	ktl::vector<ktl::unicode_string<>, ktl::paged_pool_allocator> patterns;
+
+	// Enough patterns to need several groups.
+	for (int i = 0; i < 2000; ++i)
+	{
+		wchar_t buffer[] = L"*\\dir0000\\<.l?g";
+		buffer[5] = static_cast<wchar_t>(L'0' + i / 1000);
+		buffer[6] = static_cast<wchar_t>(L'0' + i / 100 % 10);
+		buffer[7] = static_cast<wchar_t>(L'0' + i / 10 % 10);
+		buffer[8] = static_cast<wchar_t>(L'0' + i % 10);
+
+		ASSERT_TRUE(patterns.push_back(ktl::unicode_string<>{ static_cast<const wchar_t*>(buffer) }), "failed to add pattern");
+	}
+
+	ASSERT_TRUE(patterns.push_back(ktl::unicode_string<>{ L"*.LOG" }), "failed to add pattern");
+	ASSERT_TRUE(patterns.push_back(ktl::unicode_string<>{ L"\\Device\\HarddiskVolume1\\Temp\\*" }), "failed to add pattern");
+
+	ktl::glob_set<> set;
+	ASSERT_TRUE(set.build(patterns, true), "failed to build glob_set");
+	ASSERT_TRUE(set.size() == 2002, "unexpected glob_set size: %llu", set.size());
+
+	ASSERT_TRUE(set.find_first(L"\\Device\\HarddiskVolume1\\Logs\\DIR1234\\app.lag") == 1234, "failed to find pattern in glob_set");
+	ASSERT_TRUE(set.find_first(L"\\Device\\HarddiskVolume1\\Temp\\x.txt") == 2001, "failed to find pattern in glob_set");
+	ASSERT_FALSE(set.matches(L"\\Device\\HarddiskVolume1\\Logs\\dir2000\\app.log.txt"), "glob_set matched a name no pattern matches");
+
+	size_t count = set.for_each_match(L"\\Device\\HarddiskVolume1\\Temp\\dir0042\\old.log", [](size_t) { return true; });
+	ASSERT_TRUE(count == 3, "unexpected number of glob_set matches: %llu", count);
+
+	return true;
+}
+
+bool test_glob()
+{
+	__try
+	{
+		if (!test_glob_pattern())
+			return false;
+
+		if (!test_glob_set())
+			return false;
+	}
+	__except (EXCEPTION_EXECUTE_HANDLER)
+	{
+		LOG_ERROR("[NG]: %#x\n", GetExceptionCode());
+		return false;
+	}
+
+	LOG_TRACE("[OK] ktl::glob!\n");
+	return true;
+}
\ No newline at end of file
@@ -22,6 +22,95 @@ bool test_list_copy()
 	return true;
 }
 
+bool test_list_splice()
+{
+	ktl::list<int> a;
+	ktl::list<int> b;
+
+	ASSERT_TRUE(a.push_back_n(3, 7), "failed to push multiple elements to list");
+	ASSERT_TRUE(a.size() == 3, "unexpected list size after push_back_n: %llu", a.size());
+
+	for (auto& element : a)
+		ASSERT_TRUE(element == 7, "unexpected value after push_back_n: %d", element);
+
+	for (int i = 0; i < 3; ++i)
+		ASSERT_TRUE(b.push_back(i), "failed to push element to back of list");
+
+	// Splice all of b to the front of a: 0, 1, 2, 7, 7, 7
+	a.splice(a.begin(), b);
+	ASSERT_TRUE(b.empty(), "list was not empty after being spliced from");
+	ASSERT_TRUE(a.size() == 6, "unexpected list size after splice: %llu", a.size());
+	ASSERT_TRUE(a.front() == 0 && a.back() == 7, "unexpected list order after splice");
+
+	// Splice the first element of a to the back of b.
+	b.splice(b.end(), a, a.begin());
+	ASSERT_TRUE(a.size() == 5 && b.size() == 1, "unexpected list sizes after single element splice");
+	ASSERT_TRUE(a.front() == 1 && b.front() == 0, "unexpected values after single element splice");
+
+	return true;
+}
+
+bool test_list_node_handle()
+{
+	ktl::list<complex_object> a;
+	ktl::list<complex_object> b;
+
+	for (int i = 0; i < 4; ++i)
+		ASSERT_TRUE(a.emplace_back(), "failed to emplace element to back of list");
+
+	auto node = a.extract(a.begin());
+	ASSERT_TRUE(!node.empty(), "extracted node handle was empty");
+	ASSERT_TRUE(a.size() == 3, "unexpected list size after extract: %llu", a.size());
+
+	auto it = b.insert(b.end(), ktl::move(node));
+	ASSERT_TRUE(it != b.end(), "insert of node handle failed");
+	ASSERT_TRUE(node.empty(), "node handle was not empty after insert");
+	ASSERT_TRUE(b.size() == 1, "unexpected list size after insert: %llu", b.size());
+
+	// Dropping an extracted node frees its element.
+	{
+		auto dropped = a.extract(a.begin());
+		ASSERT_TRUE(dropped, "extracted node handle was empty");
+	}
+
+	ASSERT_TRUE(a.size() == 2, "unexpected list size after dropping node: %llu", a.size());
+
+	// Self move-assignment keeps the node.
+	auto& same = node;
+	node = b.extract(b.begin());
+	node = ktl::move(same);
+	ASSERT_TRUE(!node.empty(), "self move-assignment released the node");
+
+	// Recycled nodes are served from the list's cache.
+	a.clear();
+	complex_object* recycled[4] = {};
+	for (int i = 0; i < 4; ++i)
+	{
+		auto value = a.emplace_back();
+		ASSERT_TRUE(value, "failed to emplace element to back of list");
+		recycled[i] = value.get();
+	}
+
+	a.clear();
+	for (int i = 0; i < 4; ++i)
+	{
+		auto value = a.emplace_back();
+		ASSERT_TRUE(value, "failed to emplace element to back of list");
+
+		bool reused = false;
+		for (auto p : recycled)
+			reused |= p == value.get();
+
+		ASSERT_TRUE(reused, "node %d was not served from the node cache", i);
+	}
+
+	a.set_node_cache_limit(0);
+	a.clear();
+	ASSERT_TRUE(a.empty(), "list was not empty after clearing");
+
+	return true;
+}
+
 bool test_list()
 {
 	__try
@@ -29,6 +118,12 @@ bool test_list()
 		if (!test_list_copy())
 			return false;
 
+		if (!test_list_splice())
+			return false;
+
+		if (!test_list_node_handle())
+			return false;
+
 		ktl::list<int> int_list;
 
 		ASSERT_TRUE(int_list.empty(), "default constructed list was not empty");
@@ -142,6 +237,9 @@ bool test_list()
 		ktl::paged_lookaisde_list<int> paged_lookaside_list{ };
 		ASSERT_TRUE(paged_lookaside_list.emplace_back(1), "list emplace with custom allocator failed");
 		ASSERT_TRUE(paged_lookaside_list.emplace_back(2), "list emplace with custom allocator failed");
+
+		ktl::paged_lookaside_list<int> spelled_lookaside_list{ };
+		ASSERT_TRUE(spelled_lookaside_list.emplace_back(3), "list emplace with custom allocator failed");
 	}
 	__except (EXCEPTION_EXECUTE_HANDLER)
 	{
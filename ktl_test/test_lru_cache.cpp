@@ -0,0 +1,133 @@
+#include "test.h"
+
+#include <lru_cache>
+#include <string>
+
+bool test_lru_cache_basic()
+{
+	ktl::lru_cache<ULONG64, ULONG64> cache;
+
+	ULONG64 value = 0;
+	ASSERT_FALSE(cache.get(1, value), "uninitialized lru_cache hit");
+	ASSERT_FALSE(cache.put(1, 1ull), "uninitialized lru_cache accepted an entry");
+
+	ASSERT_TRUE(cache.initialize(1024, 4), "failed to initialize lru_cache");
+	ASSERT_TRUE(cache.shard_count() == 4 && cache.capacity() == 1024, "unexpected lru_cache capacity: %llu", cache.capacity());
+	ASSERT_FALSE(cache.initialize(1024, 3), "initialized lru_cache with a shard count which isn't a power of two");
+	ASSERT_TRUE(cache.initialize(1024, 4), "failed to initialize lru_cache");
+
+	for (ULONG64 i = 0; i < 100; ++i)
+		ASSERT_TRUE(cache.put(i, i * 10), "failed to cache %llu", i);
+
+	ASSERT_TRUE(cache.size() == 100, "unexpected lru_cache size: %llu", cache.size());
+
+	ASSERT_TRUE(cache.get(42, value) && value == 420, "failed to find cached value");
+	ASSERT_TRUE(cache.put(42, 1ull) && cache.get(42, value) && value == 1, "failed to replace cached value");
+	ASSERT_FALSE(cache.get(100, value), "found a key which was never cached");
+
+	ASSERT_TRUE(cache.erase(42), "failed to erase cached key");
+	ASSERT_FALSE(cache.erase(42), "erased a key twice");
+	ASSERT_FALSE(cache.get(42, value), "found an erased key");
+
+	// Erasing moves another entry into the hole, which must still be found.
+	for (ULONG64 i = 0; i < 100; ++i)
+	{
+		if (i != 42)
+			ASSERT_TRUE(cache.get(i, value) && value == i * 10, "lost cached key %llu after erase", i);
+	}
+
+	auto stats = cache.stats();
+	ASSERT_TRUE(stats.Size == 99 && stats.Evictions == 0, "unexpected lru_cache stats");
+	ASSERT_TRUE(stats.Hits == 101 && stats.Misses == 2, "unexpected lru_cache hit counters: %llu/%llu", stats.Hits, stats.Misses);
+
+	cache.clear();
+	ASSERT_TRUE(cache.size() == 0 && !cache.get(1, value), "cleared lru_cache still held entries");
+
+	return true;
+}
+
+bool test_lru_cache_eviction()
+{
+	// One shard, so the eviction order is predictable.
+	ktl::lru_cache<ULONG64, ULONG64> cache;
+	ASSERT_TRUE(cache.initialize(64, 1), "failed to initialize lru_cache");
+
+	for (ULONG64 i = 0; i < 64; ++i)
+		ASSERT_TRUE(cache.put(i, i), "failed to cache %llu", i);
+
+	// Keep the first half hot.
+	ULONG64 value = 0;
+	for (ULONG64 i = 0; i < 32; ++i)
+		ASSERT_TRUE(cache.get(i, value), "failed to find cached key %llu", i);
+
+	for (ULONG64 i = 64; i < 96; ++i)
+		ASSERT_TRUE(cache.put(i, i), "failed to cache %llu", i);
+
+	ASSERT_TRUE(cache.size() == 64, "lru_cache grew past its capacity: %llu", cache.size());
+
+	for (ULONG64 i = 0; i < 32; ++i)
+		ASSERT_TRUE(cache.get(i, value), "evicted recently used key %llu", i);
+
+	for (ULONG64 i = 32; i < 64; ++i)
+		ASSERT_FALSE(cache.get(i, value), "kept unused key %llu", i);
+
+	ASSERT_TRUE(cache.stats(0).Evictions == 32, "unexpected eviction count: %llu", cache.stats(0).Evictions);
+
+	size_t indexCapacity = cache.stats(0).IndexCapacity;
+	ASSERT_TRUE(indexCapacity > 0, "lru_cache index wasn't allocated up front");
+
+	// Churn far past the capacity; the index must stay in step with the entries, and sweep out
+	// the tombstones left by eviction without ever growing.
+	for (ULONG64 i = 1000; i < 11000; ++i)
+		ASSERT_TRUE(cache.put(i, i), "failed to cache %llu", i);
+
+	ASSERT_TRUE(cache.size() == 64, "lru_cache grew past its capacity: %llu", cache.size());
+	ASSERT_TRUE(cache.stats(0).IndexCapacity == indexCapacity, "lru_cache index grew from %llu to %llu slots", indexCapacity, cache.stats(0).IndexCapacity);
+
+	for (ULONG64 i = 10936; i < 11000; ++i)
+		ASSERT_TRUE(cache.get(i, value) && value == i, "failed to find recently cached key %llu", i);
+
+	return true;
+}
+
+bool test_lru_cache_strings()
+{
+	ktl::lru_cache<ULONG64, ktl::unicode_string<>> cache;
+	ASSERT_TRUE(cache.initialize_for_bytes(64 * 1024), "failed to initialize lru_cache");
+	ASSERT_TRUE(cache.capacity() > 0 && cache.capacity() * cache.entry_footprint() <= 64 * 1024, "lru_cache exceeded its byte budget");
+
+	ASSERT_TRUE(cache.put(4, ktl::unicode_string<>{ L"\\Device\\HarddiskVolume4" }), "failed to cache string");
+
+	bool matched = false;
+	ASSERT_TRUE(cache.visit(4, [&matched](const ktl::unicode_string<>& name)
+	{
+		matched = name == L"\\Device\\HarddiskVolume4";
+	}), "failed to visit cached string");
+
+	ASSERT_TRUE(matched, "cached string didn't match");
+
+	return true;
+}
+
+bool test_lru_cache()
+{
+	__try
+	{
+		if (!test_lru_cache_basic())
+			return false;
+
+		if (!test_lru_cache_eviction())
+			return false;
+
+		if (!test_lru_cache_strings())
+			return false;
+	}
+	__except (EXCEPTION_EXECUTE_HANDLER)
+	{
+		LOG_ERROR("[NG]: %#x\n", GetExceptionCode());
+		return false;
+	}
+
+	LOG_TRACE("[OK] ktl::lru_cache!\n");
+	return true;
+}
\ No newline at end of file
@@ -18,6 +18,357 @@ private:
 	size_t* count_;
 };
 
+struct CopyCounter
+{
+	CopyCounter(size_t* copies, int value = 0) :
+		copies_(copies),
+		value_(value)
+	{
+	}
+
+	CopyCounter(const CopyCounter& other) :
+		copies_(other.copies_),
+		value_(other.value_)
+	{
+		++(*copies_);
+	}
+
+	CopyCounter(CopyCounter&& other) :
+		copies_(other.copies_),
+		value_(other.value_)
+	{
+	}
+
+	CopyCounter& operator=(CopyCounter&& other)
+	{
+		copies_ = other.copies_;
+		value_ = other.value_;
+		return *this;
+	}
+
+	size_t* copies_;
+	int value_;
+};
+
+bool test_map_emplace()
+{
+	size_t copies = 0;
+	ktl::flat_map<int, CopyCounter> m;
+
+	// Moving a tuple moves every element, not just the first.
+	ktl::tuple<int, CopyCounter> t{ 1, CopyCounter{ &copies, 1 } };
+	ktl::tuple<int, CopyCounter> moved{ ktl::move(t) };
+	ASSERT_TRUE(copies == 0, "Moving a tuple copied its elements.");
+
+	ASSERT_TRUE(m.insert(1, CopyCounter{ &copies, 1 }) != m.end(), "Unexpected result of insertion.");
+	ASSERT_TRUE(m.insert(1, CopyCounter{ &copies, 2 }) != m.end(), "Unexpected result of insertion.");
+	ASSERT_TRUE(copies == 0, "Inserting an rvalue copied it.");
+
+	{
+		// The value is only built if the key is absent.
+		auto it = m.try_emplace(1, &copies, 3);
+		ASSERT_TRUE(it != m.end(), "Unexpected result of try_emplace.");
+		auto& [key, value] = *it;
+		ASSERT_TRUE(key == 1 && value.value_ == 2, "try_emplace replaced an existing element.");
+	}
+
+	{
+		auto it = m.try_emplace(2, &copies, 4);
+		ASSERT_TRUE(it != m.end(), "Unexpected result of try_emplace.");
+		auto& [key, value] = *it;
+		ASSERT_TRUE(key == 2 && value.value_ == 4, "Unexpected element after try_emplace.");
+	}
+
+	{
+		auto it = m.insert_or_assign(2, CopyCounter{ &copies, 5 });
+		ASSERT_TRUE(it != m.end(), "Unexpected result of insert_or_assign.");
+		auto& [key, value] = *it;
+		ASSERT_TRUE(key == 2 && value.value_ == 5, "insert_or_assign didn't assign the value.");
+
+		ASSERT_TRUE(m.insert_or_assign(3, CopyCounter{ &copies, 6 }) != m.end(), "Unexpected result of insert_or_assign.");
+	}
+
+	ASSERT_TRUE(m.size() == 3, "Unexpected map size after emplacement (%llu).", m.size());
+	ASSERT_TRUE(copies == 0, "Emplacement copied a value.");
+
+	ktl::flat_map<int, int> counts;
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		// A missing key gets a default constructed value.
+		auto it = counts.try_emplace(i % 10);
+		ASSERT_TRUE(it != counts.end(), "Unexpected result of try_emplace.");
+		++ktl::get<1>(*it);
+	}
+
+	ASSERT_TRUE(counts.size() == 10 && ktl::get<1>(*counts.find(7)) == 100, "Unexpected counts from try_emplace.");
+
+	// Fill to the load limit, so only a new key may grow the map.
+	ktl::flat_map<int, int> full;
+	ASSERT_TRUE(full.reserve(16), "Failed to reserve map.");
+
+	for (int i = 0; i < 13; ++i)
+		ASSERT_TRUE(full.insert(i, i) != full.end(), "Unexpected result of insertion.");
+
+	ASSERT_TRUE(full.capacity() == 16, "Unexpected capacity for a full map (%llu).", full.capacity());
+
+	ASSERT_TRUE(full.try_emplace(4, 0) != full.end(), "Unexpected result of try_emplace.");
+	ASSERT_TRUE(full.insert_or_assign(5, 50) != full.end(), "Unexpected result of insert_or_assign.");
+	ASSERT_TRUE(full.capacity() == 16, "Updating existing keys grew the map to %llu.", full.capacity());
+	ASSERT_TRUE(ktl::get<1>(*full.find(4)) == 4 && ktl::get<1>(*full.find(5)) == 50, "Unexpected values after updating existing keys.");
+
+	ASSERT_TRUE(full.try_emplace(13) != full.end(), "Unexpected result of try_emplace.");
+	ASSERT_TRUE(full.capacity() == 32 && full.size() == 14, "Inserting past the load limit didn't grow the map (%llu).", full.capacity());
+
+	return true;
+}
+
+bool test_map_iteration()
+{
+	// A sparse table, where slot 0 is unlikely to be the first full one.
+	ktl::flat_map<int, int> m;
+	ASSERT_TRUE(m.begin() == m.end(), "Empty map had elements.");
+	ASSERT_TRUE(m.reserve(4096), "Unable to reserve map capacity!");
+
+	for (int i = 1; i <= 5; ++i)
+		ASSERT_TRUE(m.insert(i * 1000, i) != m.end(), "Unexpected result of insertion.");
+
+	int sum = 0;
+	size_t count = 0;
+
+	for (auto it = m.begin(); it != m.end(); ++it)
+	{
+		auto& [key, value] = *it;
+		ASSERT_TRUE(key == value * 1000, "Iteration visited an empty slot.");
+		sum += value;
+		++count;
+	}
+
+	ASSERT_TRUE(count == 5 && sum == 15, "Iteration didn't visit each element once (%llu).", count);
+
+	sum = 0;
+	m.for_each_occupied([&sum](const int& key, int& value)
+	{
+		sum += key / 1000;
+		value = 0;
+	});
+
+	ASSERT_TRUE(sum == 15, "for_each_occupied didn't visit each element once.");
+
+	{
+		auto it = m.find(3000);
+		auto [key, value] = *it;
+		ASSERT_TRUE(value == 0, "for_each_occupied couldn't modify values.");
+	}
+
+	// Iteration covers both tables while a resize is in progress.
+	ktl::flat_map<int, int> incremental;
+	incremental.incremental_rehash(true);
+
+	for (int i = 0; !incremental.rehashing() || i < 2000; ++i)
+		ASSERT_TRUE(incremental.insert(i, i) != incremental.end(), "Unexpected result of insertion.");
+
+	count = 0;
+	for (auto it = incremental.begin(); it != incremental.end(); ++it)
+		++count;
+
+	ASSERT_TRUE(incremental.rehashing() && count == incremental.size(), "Iteration during rehash visited %llu of %llu elements.", count, incremental.size());
+
+	// Trivially destructible elements are cleared by resetting the control bytes.
+	incremental.clear();
+	ASSERT_TRUE(incremental.size() == 0 && incremental.begin() == incremental.end(), "Elements left after clear.");
+	ASSERT_TRUE(incremental.find(5) == incremental.end(), "Found key after clear.");
+	ASSERT_TRUE(incremental.insert(5, 5) != incremental.end() && incremental.size() == 1, "Unable to reuse map after clear.");
+
+	return true;
+}
+
+bool test_map_batch()
+{
+	ktl::flat_map<int, int> m;
+	m.incremental_rehash(true);
+
+	// Stop mid-rehash, so batches span both tables.
+	int count = 0;
+	for (; !m.rehashing() || count < 2000; ++count)
+		ASSERT_TRUE(m.insert(count * 2, count) != m.end(), "Unexpected result of insertion.");
+
+	int keys[100];
+	ktl::flat_map<int, int>::iterator results[100];
+
+	for (int i = 0; i < 100; ++i)
+		keys[i] = i * 41;
+
+	size_t found = m.find_batch(keys, 100, results);
+	size_t expected = 0;
+
+	for (int i = 0; i < 100; ++i)
+	{
+		if (keys[i] % 2 != 0 || keys[i] / 2 >= count)
+		{
+			ASSERT_TRUE(results[i] == m.end(), "Batch found absent key %d.", keys[i]);
+			continue;
+		}
+
+		ASSERT_TRUE(results[i] != m.end(), "Batch didn't find key %d.", keys[i]);
+		auto [key, value] = *results[i];
+		ASSERT_TRUE(key == keys[i] && value == key / 2, "Batch found the wrong element for key %d.", keys[i]);
+		++expected;
+	}
+
+	ASSERT_TRUE(found == expected, "Unexpected number of keys found in batch: %llu", found);
+
+	ktl::flat_map<int, int> empty;
+	ASSERT_TRUE(empty.find_batch(keys, 100, results) == 0 && results[0] == empty.end(), "Empty map contained keys.");
+
+	return true;
+}
+
+bool test_map_stats()
+{
+	ktl::flat_map<int, int> m;
+
+	for (int i = 0; i < 1000; ++i)
+		ASSERT_TRUE(m.insert(i, i) != m.end(), "Unexpected result of insertion.");
+
+	for (int i = 0; i < 100; ++i)
+		(void)m.erase(i);
+
+	for (int i = 0; i < 2000; ++i)
+		(void)m.find(i);
+
+	auto stats = m.stats();
+	ASSERT_TRUE(stats.Size == 900 && stats.Capacity == m.capacity() && stats.Tombstones == 100, "Unexpected map stats sizes.");
+	ASSERT_TRUE(stats.Rehashes > 0, "Growth wasn't counted as a rehash.");
+	ASSERT_TRUE(stats.Groups == m.capacity() / 16 && stats.FullGroups <= stats.Groups, "Unexpected map group counts.");
+
+	size_t counted = 0;
+	size_t longest = 0;
+
+	for (size_t i = 0; i < ktl::flat_map_stats::HistogramBuckets; ++i)
+	{
+		counted += stats.ProbeLengths[i];
+
+		if (stats.ProbeLengths[i])
+			longest = i;
+	}
+
+	ASSERT_TRUE(counted == stats.Size, "Probe length histogram didn't cover every element (%llu).", counted);
+	ASSERT_TRUE(longest == 0 ? stats.MaxProbeLength == 0 : stats.MaxProbeLength >= (1ull << (longest - 1)), "Max probe length didn't match histogram.");
+
+#if KTL_MAP_PROBE_SAMPLE_RATE
+	ASSERT_TRUE(stats.SampledFinds == 2000 / KTL_MAP_PROBE_SAMPLE_RATE, "Unexpected number of sampled finds (%llu).", stats.SampledFinds);
+#endif
+
+	return true;
+}
+
+// Padding follows ProcessId, so the key has to be hashed member-wise.
+struct HandleKey
+{
+	ULONG ProcessId;
+	HANDLE Handle;
+
+	bool operator==(const HandleKey& other) const
+	{
+		return ProcessId == other.ProcessId && Handle == other.Handle;
+	}
+};
+
+namespace ktl
+{
+	template<>
+	struct hash<HandleKey, void>
+	{
+		[[nodiscard]] hash_t operator()(const HandleKey& key) const
+		{
+			return hash_values(key.ProcessId, key.Handle);
+		}
+	};
+}
+
+enum class KeyKind : ULONG
+{
+	Process = 1,
+};
+
+static_assert(ktl::hash<int>{}(42) == ktl::hash<unsigned long long>{}(42));
+static_assert(ktl::hash<KeyKind>{}(KeyKind::Process) == ktl::hash<ULONG>{}(1));
+static_assert(ktl::hash_values(1, 2) != ktl::hash_values(2, 1));
+
+bool test_map_hash()
+{
+	// The runtime multiply must agree with the constant evaluated one.
+	constexpr ktl::hash_t expected = ktl::hash<ULONG64>{}(0x123456789abcdefull);
+	volatile ULONG64 key = 0x123456789abcdefull;
+	ASSERT_TRUE(ktl::hash<ULONG64>{}(key) == expected, "Runtime integer hash didn't match constexpr hash.");
+
+	ktl::flat_map<HandleKey, int> handles;
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		HandleKey k;
+		RtlFillMemory(&k, sizeof(k), static_cast<UCHAR>(i));
+
+		k.ProcessId = i % 10;
+		k.Handle = ULongToHandle(i * 4);
+		ASSERT_TRUE(handles.insert(k, i) != handles.end(), "Unexpected result of insertion.");
+	}
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		HandleKey k;
+		RtlZeroMemory(&k, sizeof(k));
+
+		k.ProcessId = i % 10;
+		k.Handle = ULongToHandle(i * 4);
+
+		auto it = handles.find(k);
+		ASSERT_TRUE(it != handles.end() && ktl::get<1>(*it) == i, "Failed to find key %d with different padding.", i);
+	}
+
+	using handle_tuple = ktl::tuple<ULONG, HANDLE>;
+	handle_tuple t{ 4ul, ULongToHandle(8) };
+	ASSERT_TRUE(ktl::hash<handle_tuple>{}(t) == ktl::hash_values(4ul, ULongToHandle(8)), "Tuple wasn't hashed member-wise.");
+	ASSERT_TRUE(ktl::hash<HANDLE>{}(ULongToHandle(8)) == ktl::hash<ULONG_PTR>{}(8), "Pointer wasn't hashed as an integer.");
+
+	return true;
+}
+
+bool test_map_seeded()
+{
+	ASSERT_TRUE(ktl::seeded_hash(42ull, 0) == ktl::hash<ULONG64>{}(42), "Zero seed changed the hash.");
+	ASSERT_TRUE(ktl::seeded_hash(42ull, 1) != ktl::seeded_hash(42ull, 2), "Seed didn't change the hash.");
+
+	ktl::flat_map<ULONG64, ULONG64> a{ ktl::random_seed };
+	ktl::flat_map<ULONG64, ULONG64> b{ ktl::random_seed };
+
+	// Grows through several rehashes, which must keep hashing with the same seed.
+	for (ULONG64 i = 0; i < 10000; ++i)
+	{
+		ASSERT_TRUE(a.insert(i, i * 2) != a.end(), "Unexpected result of insertion.");
+		ASSERT_TRUE(b.insert(i * 3, i) != b.end(), "Unexpected result of insertion.");
+	}
+
+	for (ULONG64 i = 0; i < 10000; i += 2)
+		(void)a.erase(i);
+
+	for (ULONG64 i = 0; i < 10000; ++i)
+	{
+		auto it = a.find(i);
+		ASSERT_TRUE((it != a.end()) == (i % 2 == 1), "Unexpected result finding key %llu in seeded map.", i);
+		ASSERT_TRUE(b.find(i * 3) != b.end() && ktl::get<1>(*b.find(i * 3)) == i, "Failed to find key %llu in seeded map.", i * 3);
+	}
+
+	ktl::flat_map<ktl::unicode_string_view, int> names{ ktl::random_seed };
+	ASSERT_TRUE(names.insert(ktl::unicode_string_view{ L"\\Registry\\Machine" }, 1) != names.end(), "Unexpected result of insertion.");
+	ASSERT_TRUE(names.insert(ktl::unicode_string_view{ L"\\Registry\\User" }, 2) != names.end(), "Unexpected result of insertion.");
+	ASSERT_TRUE(names.find(ktl::unicode_string_view{ L"\\Registry\\User" }) != names.end(), "Failed to find string in seeded map.");
+	ASSERT_TRUE(names.find(ktl::unicode_string_view{ L"\\Registry\\Users" }) == names.end(), "Found missing string in seeded map.");
+
+	return true;
+}
+
 bool test_map()
 {
 	__try
@@ -77,6 +428,81 @@ bool test_map()
 			ASSERT_TRUE(value == key + 1, "Unexpected value of value of found element.");
 		}
 
+		{
+			// Keys displaced past an erased slot must still be found, and churn mustn't
+			// grow the table.
+			ktl::flat_map<int, int> churn;
+
+			for (int i = 0; i < 20000; ++i)
+			{
+				ASSERT_TRUE(churn.insert(i, i) != churn.end(), "Unexpected result of insertion.");
+
+				if (i >= 40)
+					(void)churn.erase(i - 40);
+
+				ASSERT_TRUE(churn.size() == (i < 40 ? i + 1 : 40), "Unexpected map size during churn (%llu).", churn.size());
+			}
+
+			for (int i = 20000 - 40; i < 20000; ++i)
+				ASSERT_TRUE(churn.find(i) != churn.end(), "Failed to find key %d after churn.", i);
+
+			ASSERT_TRUE(churn.capacity() <= 128, "Map grew during churn (%llu).", churn.capacity());
+		}
+
+		{
+			// Growth migrates a few groups per operation, with lookups spanning both tables.
+			ktl::flat_map<int, int> incremental;
+			incremental.incremental_rehash(true);
+
+			bool sawRehash = false;
+
+			for (int i = 0; i < 100000; ++i)
+			{
+				ASSERT_TRUE(incremental.insert(i, i * 2) != incremental.end(), "Unexpected result of insertion.");
+
+				if (incremental.rehashing())
+				{
+					sawRehash = true;
+
+					// Keys inserted before the growth, both migrated and not, must still be found.
+					auto it = incremental.find(i / 2);
+					ASSERT_TRUE(it != incremental.end(), "Failed to find key %d during rehash.", i / 2);
+					auto [key, value] = *it;
+					ASSERT_TRUE(key == i / 2 && value == key * 2, "Unexpected element found during rehash.");
+
+					// Overwriting a key which may not have been migrated mustn't duplicate it.
+					ASSERT_TRUE(incremental.insert(i / 2, value) != incremental.end(), "Unexpected result of insertion.");
+				}
+
+				if (i % 3 == 0)
+					(void)incremental.erase(i / 3);
+			}
+
+			ASSERT_TRUE(sawRehash, "Map never rehashed incrementally.");
+			ASSERT_TRUE(incremental.size() == 100000 - 33334, "Unexpected map size after incremental rehash (%llu).", incremental.size());
+
+			for (int i = 0; i < 100000; ++i)
+				ASSERT_TRUE((incremental.find(i) != incremental.end()) == (i >= 33334), "Unexpected result finding key %d after incremental rehash.", i);
+		}
+
+		if (!test_map_emplace())
+			return false;
+
+		if (!test_map_iteration())
+			return false;
+
+		if (!test_map_batch())
+			return false;
+
+		if (!test_map_stats())
+			return false;
+
+		if (!test_map_hash())
+			return false;
+
+		if (!test_map_seeded())
+			return false;
+
 		ktl::flat_map<int, DestructorCounter> counter;
 		size_t actualCount = 50;
 		size_t destroyedCount = 0;
@@ -1,11 +1,45 @@
 ﻿#include "test.h"
 
+#include <list>
+#include <map>
 #include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+// Containers don't bind their allocator until they first allocate, so these
+// are constant-initialized rather than run from .CRT$XCU.
+constinit ktl::vector<int> g_constinit_vector;
+constinit ktl::list<int> g_constinit_list;
+constinit ktl::unicode_string<> g_constinit_string;
+constinit ktl::unordered_set<int> g_constinit_set;
+constinit ktl::flat_map<int, int> g_constinit_map;
 
 bool test_memory()
 {
 	__try
 	{
+		{
+			ASSERT_TRUE(g_constinit_vector.empty() && g_constinit_list.empty() && g_constinit_string.empty(), "constinit container wasn't empty");
+			ASSERT_TRUE(g_constinit_set.size() == 0 && g_constinit_map.size() == 0, "constinit container wasn't empty");
+
+			ASSERT_TRUE(g_constinit_vector.push_back(1) && g_constinit_list.push_back(2), "failed to insert into constinit container");
+			ASSERT_TRUE(g_constinit_set.insert(3), "failed to insert into constinit set");
+			ASSERT_TRUE(g_constinit_map.insert(4, 5) != g_constinit_map.end(), "failed to insert into constinit map");
+
+			g_constinit_string = ktl::unicode_string<>{ L"constinit" };
+			ASSERT_TRUE(g_constinit_string == L"constinit", "unexpected value in constinit string");
+
+			ASSERT_TRUE(g_constinit_vector[0] == 1 && *g_constinit_list.begin() == 2, "unexpected value in constinit container");
+			ASSERT_TRUE(g_constinit_set.contains(3) && g_constinit_map.find(4) != g_constinit_map.end(), "failed to find value in constinit container");
+
+			g_constinit_vector.clear();
+			g_constinit_list.clear();
+			g_constinit_string.clear();
+			g_constinit_set.erase(3);
+			g_constinit_map.clear();
+		}
+
 		{
 			ktl::unique_ptr<int> simple_ptr = ktl::make_unique<int>(ktl::pool_type::NonPaged, 5);
 			ASSERT_TRUE(simple_ptr, "unexpectedly failed to allocate unique_ptr");
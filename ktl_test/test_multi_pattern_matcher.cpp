@@ -0,0 +1,128 @@
+#include "test.h"
+
+#include <multi_pattern_matcher>
+
+bool test_multi_pattern_matcher_overlapping()
+{
+	ktl::vector<ktl::unicode_string<>, ktl::paged_pool_allocator> patterns;
+
+	ASSERT_TRUE(patterns.push_back(ktl::unicode_string<>{ L"he" }), "failed to add pattern");
+	ASSERT_TRUE(patterns.push_back(ktl::unicode_string<>{ L"she" }), "failed to add pattern");
+	ASSERT_TRUE(patterns.push_back(ktl::unicode_string<>{ L"his" }), "failed to add pattern");
+	ASSERT_TRUE(patterns.push_back(ktl::unicode_string<>{ L"hers" }), "failed to add pattern");
+
+	ktl::multi_pattern_matcher<> matcher;
+	ASSERT_FALSE(matcher.contains_any(L"she"), "unbuilt multi_pattern_matcher matched");
+	ASSERT_TRUE(matcher.build(patterns), "failed to build multi_pattern_matcher");
+	ASSERT_TRUE(matcher.size() == 4, "unexpected pattern count: %llu", matcher.size());
+
+	struct expected_match
+	{
+		size_t Pattern;
+		size_t Offset;
+	};
+
+	// Matches are reported in order of where they end, longest first.
+	const expected_match expected[] = { { 1, 1 }, { 0, 2 }, { 3, 2 } };
+	size_t index = 0;
+	bool ordered = true;
+
+	size_t count = matcher.for_each_match(L"ushers", [&](const ktl::multi_pattern_match& match)
+	{
+		if (index >= ARRAYSIZE(expected) || match.Pattern != expected[index].Pattern || match.Offset != expected[index].Offset)
+			ordered = false;
+
+		++index;
+		return true;
+	});
+
+	ASSERT_TRUE(count == 3 && index == 3, "unexpected number of matches: %llu", count);
+	ASSERT_TRUE(ordered, "matches weren't reported in order");
+
+	auto first = matcher.find_first(L"ushers");
+	ASSERT_TRUE(first && first.Pattern == 1 && first.Offset == 1 && first.Length == 3, "unexpected first match");
+
+	// Stopping early reports no further matches.
+	count = matcher.for_each_match(L"ushers", [](const ktl::multi_pattern_match&) { return false; });
+	ASSERT_TRUE(count == 1, "scanning didn't stop when asked to");
+
+	ASSERT_FALSE(matcher.contains_any(L"USHERS"), "case sensitive multi_pattern_matcher ignored case");
+	ASSERT_FALSE(matcher.contains_any(L"hi s"), "matched text without any pattern");
+	ASSERT_FALSE(matcher.contains_any(L""), "matched empty text");
+
+	return true;
+}
+
+bool test_multi_pattern_matcher_case_insensitive()
+{
+	ktl::vector<ktl::unicode_string_view, ktl::paged_pool_allocator> patterns;
+
+	ASSERT_TRUE(patterns.push_back(ktl::unicode_string_view{ L"MIMIKATZ" }), "failed to add pattern");
+	ASSERT_TRUE(patterns.push_back(ktl::unicode_string_view{ L"-EncodedCommand" }), "failed to add pattern");
+	ASSERT_TRUE(patterns.push_back(ktl::unicode_string_view{ L"\\AppData\\Local\\Temp\\" }), "failed to add pattern");
+
+	ktl::multi_pattern_matcher<> matcher;
+	ASSERT_TRUE(matcher.build(patterns, true), "failed to build multi_pattern_matcher");
+
+	auto match = matcher.find_first(L"powershell.exe -nop -encodedcommand SQBFAFgA");
+	ASSERT_TRUE(match && match.Pattern == 1 && match.Offset == 20, "case insensitive multi_pattern_matcher didn't fold case");
+
+	match = matcher.find_first(L"C:\\Users\\x\\appdata\\local\\temp\\Mimikatz.exe");
+	ASSERT_TRUE(match && match.Pattern == 2, "case insensitive multi_pattern_matcher didn't fold case");
+
+	ASSERT_FALSE(matcher.contains_any(L"C:\\Windows\\System32\\cmd.exe /c dir"), "matched text without any pattern");
+
+	return true;
+}
+
+bool test_multi_pattern_matcher_many()
+{
+	ktl::vector<ktl::unicode_string<>, ktl::paged_pool_allocator> patterns;
+
+	// Several hundred patterns with shared prefixes & suffixes.
+	for (int i = 0; i < 500; ++i)
+	{
+		wchar_t buffer[] = L"bad000.sys";
+		buffer[3] = static_cast<wchar_t>(L'0' + i / 100);
+		buffer[4] = static_cast<wchar_t>(L'0' + i / 10 % 10);
+		buffer[5] = static_cast<wchar_t>(L'0' + i % 10);
+
+		ASSERT_TRUE(patterns.push_back(ktl::unicode_string<>{ static_cast<const wchar_t*>(buffer) }), "failed to add pattern");
+	}
+
+	ktl::multi_pattern_matcher<> matcher;
+	ASSERT_TRUE(matcher.build(patterns), "failed to build multi_pattern_matcher");
+
+	auto match = matcher.find_first(L"\\SystemRoot\\System32\\drivers\\bad427.sys");
+	ASSERT_TRUE(match && match.Pattern == 427 && match.Offset == 29 && match.Length == 10, "failed to find pattern among many");
+
+	ASSERT_FALSE(matcher.contains_any(L"\\SystemRoot\\System32\\drivers\\bad500.sys"), "matched a pattern which wasn't in the set");
+
+	size_t count = matcher.for_each_match(L"bad001.sysbad002.sysbad001.sys", [](const ktl::multi_pattern_match&) { return true; });
+	ASSERT_TRUE(count == 3, "unexpected number of matches: %llu", count);
+
+	return true;
+}
+
+bool test_multi_pattern_matcher()
+{
+	__try
+	{
+		if (!test_multi_pattern_matcher_overlapping())
+			return false;
+
+		if (!test_multi_pattern_matcher_case_insensitive())
+			return false;
+
+		if (!test_multi_pattern_matcher_many())
+			return false;
+	}
+	__except (EXCEPTION_EXECUTE_HANDLER)
+	{
+		LOG_ERROR("[NG]: %#x\n", GetExceptionCode());
+		return false;
+	}
+
+	LOG_TRACE("[OK] ktl::multi_pattern_matcher!\n");
+	return true;
+}
\ No newline at end of file
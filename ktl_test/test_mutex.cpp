@@ -0,0 +1,274 @@
+#include "test.h"
+
+#include <mutex>
+#include <shared_mutex>
+
+bool test_mutex_spin_lock()
+{
+	ktl::spin_lock lock;
+
+	KIRQL oldIrql = lock.lock();
+	ASSERT_TRUE(KeGetCurrentIrql() == DISPATCH_LEVEL, "spin_lock didn't raise to DISPATCH_LEVEL: %u", KeGetCurrentIrql());
+	ASSERT_FALSE(KeTestSpinLock(lock.native_handle()), "spin_lock wasn't held after lock()");
+	ASSERT_FALSE(lock.try_lock_at_dpc_level(), "try_lock_at_dpc_level acquired a held spin_lock");
+	lock.unlock(oldIrql);
+
+	ASSERT_TRUE(KeGetCurrentIrql() == oldIrql, "spin_lock didn't restore the previous IRQL: %u", KeGetCurrentIrql());
+	ASSERT_TRUE(KeTestSpinLock(lock.native_handle()), "spin_lock was still held after unlock()");
+
+	{
+		ktl::scoped_lock guard{ lock };
+		ASSERT_FALSE(KeTestSpinLock(lock.native_handle()), "spin_lock wasn't held by scoped_lock");
+
+		ktl::spin_lock other;
+		ASSERT_TRUE(other.try_lock_at_dpc_level(), "try_lock_at_dpc_level failed on a free spin_lock");
+		other.unlock_from_dpc_level();
+	}
+
+	ASSERT_TRUE(KeTestSpinLock(lock.native_handle()), "scoped_lock didn't release the spin_lock");
+
+	{
+		ktl::unique_lock guard{ lock };
+		ASSERT_TRUE(guard.owns_lock(), "unique_lock didn't own the spin_lock");
+
+		guard.unlock();
+		ASSERT_TRUE(KeTestSpinLock(lock.native_handle()), "unique_lock::unlock didn't release the spin_lock");
+		ASSERT_TRUE(KeGetCurrentIrql() == oldIrql, "unique_lock::unlock didn't restore the previous IRQL: %u", KeGetCurrentIrql());
+
+		guard.lock();
+		ASSERT_FALSE(KeTestSpinLock(lock.native_handle()), "unique_lock::lock didn't reacquire the spin_lock");
+	}
+
+	ASSERT_TRUE(KeTestSpinLock(lock.native_handle()), "unique_lock didn't release the spin_lock");
+	return true;
+}
+
+bool test_mutex_queued_spin_lock()
+{
+	ktl::queued_spin_lock lock;
+	KIRQL oldIrql = KeGetCurrentIrql();
+
+	{
+		ktl::in_stack_queued_lock guard{ lock };
+		ASSERT_TRUE(KeGetCurrentIrql() == DISPATCH_LEVEL, "in_stack_queued_lock didn't raise to DISPATCH_LEVEL: %u", KeGetCurrentIrql());
+		ASSERT_FALSE(KeTestSpinLock(lock.native_handle()), "queued_spin_lock wasn't held by in_stack_queued_lock");
+	}
+
+	ASSERT_TRUE(KeGetCurrentIrql() == oldIrql, "in_stack_queued_lock didn't restore the previous IRQL: %u", KeGetCurrentIrql());
+	ASSERT_TRUE(KeTestSpinLock(lock.native_handle()), "in_stack_queued_lock didn't release the queued_spin_lock");
+
+	{
+		// Get to DISPATCH_LEVEL by holding an unrelated lock.
+		ktl::spin_lock other;
+		ktl::scoped_lock raised{ other };
+
+		{
+			ktl::in_stack_queued_lock_at_dpc_level guard{ lock };
+			ASSERT_FALSE(KeTestSpinLock(lock.native_handle()), "queued_spin_lock wasn't held at DISPATCH_LEVEL");
+		}
+
+		ASSERT_TRUE(KeGetCurrentIrql() == DISPATCH_LEVEL, "in_stack_queued_lock_at_dpc_level changed the IRQL: %u", KeGetCurrentIrql());
+		ASSERT_TRUE(KeTestSpinLock(lock.native_handle()), "in_stack_queued_lock_at_dpc_level didn't release the queued_spin_lock");
+	}
+
+	// Waiters are queued, so every increment from both threads must land.
+	struct
+	{
+		ktl::queued_spin_lock* Lock;
+		ULONG Counter;
+
+		void operator()()
+		{
+			for (int i = 0; i < 10000; ++i)
+			{
+				ktl::in_stack_queued_lock guard{ *Lock };
+				++Counter;
+			}
+		}
+	} increment{ &lock, 0 };
+
+	test_thread worker{ increment };
+	ASSERT_TRUE(NT_SUCCESS(worker.start()), "failed to start contending thread");
+
+	increment();
+	worker.join();
+
+	ASSERT_TRUE(increment.Counter == 20000, "unexpected count under queued_spin_lock: %u", increment.Counter);
+	return true;
+}
+
+bool test_mutex_fast_mutex()
+{
+	ktl::mutex lock;
+	ASSERT_TRUE(lock, "mutex failed to initialize");
+
+	lock.lock();
+	ASSERT_FALSE(lock.try_lock(), "try_lock acquired a held mutex");
+	lock.unlock();
+
+	ASSERT_TRUE(lock.try_lock(), "try_lock failed on a free mutex");
+	lock.unlock();
+
+	{
+		ktl::unique_lock guard{ lock };
+		ASSERT_TRUE(guard.owns_lock(), "unique_lock didn't own the mutex");
+
+		guard.unlock();
+		ASSERT_TRUE(guard.try_lock(), "unique_lock::try_lock failed on a free mutex");
+	}
+
+	ASSERT_TRUE(lock.try_lock(), "unique_lock didn't release the mutex");
+	lock.unlock();
+
+	return true;
+}
+
+bool test_mutex_push_lock()
+{
+	ktl::push_lock lock;
+
+	struct
+	{
+		ktl::push_lock* Lock;
+		ULONG Counter;
+
+		void operator()()
+		{
+			for (int i = 0; i < 10000; ++i)
+			{
+				ktl::scoped_lock guard{ *Lock };
+				++Counter;
+			}
+		}
+	} increment{ &lock, 0 };
+
+	{
+		ktl::scoped_lock guard{ lock };
+		ASSERT_TRUE(KeAreApcsDisabled(), "push_lock was held outside a critical region");
+	}
+
+	{
+		ktl::shared_lock guard{ lock };
+		ASSERT_TRUE(KeAreApcsDisabled(), "push_lock was held shared outside a critical region");
+		ASSERT_TRUE(guard.owns_lock(), "shared_lock didn't own the push_lock");
+	}
+
+	// Would never finish if either guard above had leaked the lock.
+	test_thread worker{ increment };
+	ASSERT_TRUE(NT_SUCCESS(worker.start()), "failed to start contending thread");
+
+	increment();
+	worker.join();
+
+	ASSERT_TRUE(increment.Counter == 20000, "unexpected count under push_lock: %u", increment.Counter);
+	return true;
+}
+
+bool test_mutex_contention_tracker()
+{
+	ktl::internal::contention_tracker tracker;
+
+	tracker.on_acquired(false, 0, 0);
+	tracker.on_release();
+
+	uint64_t waitStart = ktl::internal::lock_timestamp();
+	tracker.on_acquired(true, 42, waitStart);
+	tracker.on_release();
+
+	auto stats = tracker.statistics();
+	ASSERT_TRUE(stats.Acquisitions == 2, "unexpected acquisition count: %llu", stats.Acquisitions);
+	ASSERT_TRUE(stats.Contentions == 1, "unexpected contention count: %llu", stats.Contentions);
+	ASSERT_TRUE(stats.SpinIterations == 42, "unexpected spin count: %llu", stats.SpinIterations);
+
+	tracker.reset();
+	stats = tracker.statistics();
+	ASSERT_TRUE(stats.Acquisitions == 0 && stats.Contentions == 0 && stats.SpinIterations == 0 && stats.WaitTicks == 0 && stats.HoldTicks == 0, "statistics weren't reset");
+
+#if KTL_LOCK_STATISTICS
+	ktl::spin_lock lock;
+
+	{
+		ktl::scoped_lock guard{ lock };
+	}
+
+	stats = lock.statistics();
+	ASSERT_TRUE(stats.Acquisitions == 1 && stats.Contentions == 0, "unexpected uncontended statistics: %llu, %llu", stats.Acquisitions, stats.Contentions);
+
+	// Hold the lock until a second thread is about to acquire it. Bounded, as the other thread
+	// can't run on this processor while we spin at DISPATCH_LEVEL.
+	struct
+	{
+		ktl::spin_lock* Lock;
+		volatile LONG Go;
+		volatile LONG Waiting;
+
+		void operator()()
+		{
+			while (!Go)
+				YieldProcessor();
+
+			InterlockedExchange(&Waiting, 1);
+			ktl::scoped_lock guard{ *Lock };
+		}
+	} contend{ &lock, 0, 0 };
+
+	test_thread worker{ contend };
+	ASSERT_TRUE(NT_SUCCESS(worker.start()), "failed to start contending thread");
+
+	bool waited = false;
+	{
+		ktl::scoped_lock guard{ lock };
+		InterlockedExchange(&contend.Go, 1);
+
+		ULONG64 deadline = KeQueryInterruptTime() + 10'000'000;
+		while (!contend.Waiting && KeQueryInterruptTime() < deadline)
+			YieldProcessor();
+
+		waited = contend.Waiting != 0;
+		if (waited)
+			KeStallExecutionProcessor(100);
+	}
+
+	worker.join();
+
+	stats = lock.statistics();
+	ASSERT_TRUE(stats.Acquisitions == 3, "unexpected acquisition count: %llu", stats.Acquisitions);
+
+	if (waited)
+	{
+		ASSERT_TRUE(stats.Contentions == 1, "unexpected contention count: %llu", stats.Contentions);
+		ASSERT_TRUE(stats.SpinIterations > 0 && stats.WaitTicks > 0, "contended acquisition recorded no wait");
+	}
+#endif
+
+	return true;
+}
+
+bool test_mutex()
+{
+	__try
+	{
+		if (!test_mutex_spin_lock())
+			return false;
+
+		if (!test_mutex_queued_spin_lock())
+			return false;
+
+		if (!test_mutex_fast_mutex())
+			return false;
+
+		if (!test_mutex_push_lock())
+			return false;
+
+		if (!test_mutex_contention_tracker())
+			return false;
+	}
+	__except (EXCEPTION_EXECUTE_HANDLER)
+	{
+		LOG_ERROR("[NG]: %#x\n", GetExceptionCode());
+		return false;
+	}
+
+	LOG_TRACE("[OK] ktl::mutex!\n");
+	return true;
+}
\ No newline at end of file
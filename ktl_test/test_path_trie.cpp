@@ -0,0 +1,141 @@
+#include "test.h"
+
+#include <path_trie>
+
+bool test_path_trie_longest_prefix()
+{
+	ktl::path_trie<int> trie;
+
+	ASSERT_TRUE(trie.insert(L"\\Device\\HarddiskVolume1\\", 1), "failed to insert into path_trie");
+	ASSERT_TRUE(trie.insert(L"\\Device\\HarddiskVolume1\\Windows\\", 2), "failed to insert into path_trie");
+	ASSERT_TRUE(trie.insert(L"\\Device\\HarddiskVolume1\\Windows\\System32\\", 3), "failed to insert into path_trie");
+	ASSERT_TRUE(trie.insert(L"\\Device\\HarddiskVolume2\\", 4), "failed to insert into path_trie");
+	ASSERT_TRUE(trie.insert(L"\\Device\\Mup\\", 5), "failed to insert into path_trie");
+
+	// The last insertion of a prefix wins.
+	ASSERT_TRUE(trie.insert(L"\\Device\\Mup\\", 6), "failed to insert duplicate into path_trie");
+
+	ASSERT_FALSE(trie.matches(L"\\Device\\Mup\\server\\share"), "unfrozen path_trie matched a path");
+	ASSERT_TRUE(trie.freeze(), "failed to freeze path_trie");
+	ASSERT_TRUE(trie.size() == 5, "duplicates weren't removed: %llu", trie.size());
+
+	auto match = trie.longest_prefix(L"\\Device\\HarddiskVolume1\\Windows\\System32\\drivers\\etc\\hosts");
+	ASSERT_TRUE(match && *match.Value == 3, "failed to find the longest prefix");
+	ASSERT_TRUE(match.Length == 41, "unexpected prefix length: %llu", match.Length);
+
+	match = trie.longest_prefix(L"\\Device\\HarddiskVolume1\\Windows\\SysWOW64\\ntdll.dll");
+	ASSERT_TRUE(match && *match.Value == 2, "failed to fall back to a shorter prefix");
+
+	match = trie.longest_prefix(L"\\Device\\HarddiskVolume1\\Users");
+	ASSERT_TRUE(match && *match.Value == 1, "failed to fall back to the shortest prefix");
+
+	match = trie.longest_prefix(L"\\Device\\Mup\\server\\share");
+	ASSERT_TRUE(match && *match.Value == 6, "duplicate prefix didn't keep the last inserted value");
+
+	ASSERT_FALSE(trie.matches(L"\\Device\\HarddiskVolume3\\"), "matched a path with no prefix");
+	ASSERT_FALSE(trie.matches(L"\\Device\\HarddiskVolume1"), "matched a path shorter than every prefix");
+	ASSERT_FALSE(trie.matches(L""), "matched an empty path");
+	ASSERT_FALSE(trie.matches(L"\\device\\mup\\"), "case sensitive path_trie ignored case");
+
+	ASSERT_TRUE(trie.find(L"\\Device\\HarddiskVolume2\\"), "failed to find exact prefix");
+	ASSERT_FALSE(trie.find(L"\\Device\\HarddiskVolume2\\x"), "found a path which was only prefixed");
+	ASSERT_FALSE(trie.find(L"\\Device\\"), "found a prefix which was never inserted");
+
+	// Inserting after freezing requires another freeze.
+	ASSERT_TRUE(trie.insert(L"", 0), "failed to insert into frozen path_trie");
+	ASSERT_FALSE(trie.frozen(), "path_trie was still frozen after insertion");
+	ASSERT_TRUE(trie.freeze(), "failed to refreeze path_trie");
+
+	match = trie.longest_prefix(L"\\??\\C:\\");
+	ASSERT_TRUE(match && *match.Value == 0 && match.Length == 0, "empty prefix didn't match every path");
+
+	return true;
+}
+
+bool test_path_trie_case_insensitive()
+{
+	ktl::path_trie<int> trie{ true };
+
+	ASSERT_TRUE(trie.insert(L"\\REGISTRY\\MACHINE\\SOFTWARE\\", 1), "failed to insert into path_trie");
+	ASSERT_TRUE(trie.insert(L"\\Registry\\Machine\\System\\CurrentControlSet\\", 2), "failed to insert into path_trie");
+	ASSERT_TRUE(trie.freeze(), "failed to freeze path_trie");
+
+	auto match = trie.longest_prefix(L"\\registry\\machine\\software\\Microsoft");
+	ASSERT_TRUE(match && *match.Value == 1, "case insensitive path_trie didn't fold case");
+
+	match = trie.longest_prefix(L"\\REGISTRY\\MACHINE\\SYSTEM\\currentcontrolset\\Services");
+	ASSERT_TRUE(match && *match.Value == 2 && match.Length == 43, "case insensitive path_trie didn't fold case");
+
+	ASSERT_FALSE(trie.matches(L"\\registry\\user\\"), "matched a path with no prefix");
+
+	return true;
+}
+
+bool test_path_trie_many()
+{
+	ktl::path_trie<ULONG> trie;
+
+	// Prefixes \A\, \A\B\, ... nested several deep, plus many siblings at each level.
+	for (ULONG i = 0; i < 1000; ++i)
+	{
+		wchar_t buffer[] = L"\\00\\000\\";
+		buffer[1] = static_cast<wchar_t>(L'0' + i / 100);
+		buffer[2] = static_cast<wchar_t>(L'0' + i / 10 % 10);
+		buffer[4] = static_cast<wchar_t>(L'0' + i / 100);
+		buffer[5] = static_cast<wchar_t>(L'0' + i / 10 % 10);
+		buffer[6] = static_cast<wchar_t>(L'0' + i % 10);
+
+		ASSERT_TRUE(trie.insert(ktl::unicode_string_view{ static_cast<const wchar_t*>(buffer) }, i), "failed to insert into path_trie");
+
+		// Each top level directory also gets a prefix of its own.
+		if (i % 10 == 0)
+			ASSERT_TRUE(trie.insert(ktl::unicode_string_view{ static_cast<const wchar_t*>(buffer), 4 }, 10000 + i / 10), "failed to insert into path_trie");
+	}
+
+	ASSERT_TRUE(trie.freeze(), "failed to freeze path_trie");
+	ASSERT_TRUE(trie.size() == 1100, "unexpected size: %llu", trie.size());
+	ASSERT_TRUE(trie.node_count() <= 2 * trie.size() + 1, "path_trie wasn't compressed: %llu nodes", trie.node_count());
+
+	for (ULONG i = 0; i < 1000; ++i)
+	{
+		wchar_t buffer[] = L"\\00\\000\\file.txt";
+		buffer[1] = static_cast<wchar_t>(L'0' + i / 100);
+		buffer[2] = static_cast<wchar_t>(L'0' + i / 10 % 10);
+		buffer[4] = static_cast<wchar_t>(L'0' + i / 100);
+		buffer[5] = static_cast<wchar_t>(L'0' + i / 10 % 10);
+		buffer[6] = static_cast<wchar_t>(L'0' + i % 10);
+
+		auto match = trie.longest_prefix(ktl::unicode_string_view{ static_cast<const wchar_t*>(buffer) });
+		ASSERT_TRUE(match && *match.Value == i && match.Length == 8, "unexpected longest prefix for %lu", i);
+
+		// A directory which doesn't match its parent's digits only matches the parent.
+		buffer[4] = L'x';
+		match = trie.longest_prefix(ktl::unicode_string_view{ static_cast<const wchar_t*>(buffer) });
+		ASSERT_TRUE(match && *match.Value == 10000 + i / 10 && match.Length == 4, "unexpected parent prefix for %lu", i);
+	}
+
+	return true;
+}
+
+bool test_path_trie()
+{
+	__try
+	{
+		if (!test_path_trie_longest_prefix())
+			return false;
+
+		if (!test_path_trie_case_insensitive())
+			return false;
+
+		if (!test_path_trie_many())
+			return false;
+	}
+	__except (EXCEPTION_EXECUTE_HANDLER)
+	{
+		LOG_ERROR("[NG]: %#x\n", GetExceptionCode());
+		return false;
+	}
+
+	LOG_TRACE("[OK] ktl::path_trie!\n");
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,219 @@
+#include "test.h"
+
+#include <map>
+#include <rcu>
+#include <set>
+#include <vector>
+
+bool test_rcu_vector()
+{
+	ktl::rcu_ptr<ktl::vector<int>> table;
+	ASSERT_TRUE(table, "failed to initialize rcu_ptr");
+
+	{
+		auto empty = table.read();
+		ASSERT_FALSE(empty, "snapshot of unpublished rcu_ptr was not empty");
+	}
+
+	ktl::vector<int> initial;
+	for (int i = 0; i < 10; ++i)
+		ASSERT_TRUE(initial.push_back(i), "failed to push element to vector");
+
+	ASSERT_TRUE(table.publish(ktl::move(initial)), "failed to publish initial version");
+
+	{
+		auto current = table.read();
+		ASSERT_TRUE(current, "snapshot of published rcu_ptr was empty");
+		ASSERT_TRUE(current->size() == 10, "unexpected size of published version: %llu", current->size());
+	}
+
+	ASSERT_TRUE(table.update([](ktl::vector<int>& draft) { return draft.push_back(10); }), "failed to update rcu_ptr");
+
+	{
+		auto current = table.read();
+		ASSERT_TRUE(current->size() == 11, "unexpected size of updated version: %llu", current->size());
+		ASSERT_TRUE((*current)[10] == 10, "unexpected value in updated version");
+	}
+
+	// A rejected update leaves the current version in place.
+	ASSERT_FALSE(table.update([](ktl::vector<int>& draft) { draft.clear(); return false; }), "rejected update was published");
+
+	{
+		auto current = table.read();
+		ASSERT_TRUE(current->size() == 11, "rejected update modified the current version");
+
+		auto moved = ktl::move(current);
+		ASSERT_FALSE(current, "snapshot was not empty after being moved from");
+		ASSERT_TRUE(moved, "moved snapshot was empty");
+	}
+
+	table.synchronize();
+	return true;
+}
+
+bool test_rcu_set()
+{
+	ktl::rcu_ptr<ktl::unordered_set<int>> policy;
+
+	for (int i = 0; i < 5; ++i)
+		ASSERT_TRUE(policy.update([i](ktl::unordered_set<int>& draft) { return draft.insert(i); }), "failed to update rcu_ptr");
+
+	auto current = policy.read();
+	ASSERT_TRUE(current->size() == 5, "unexpected size of set after updates: %llu", current->size());
+
+	for (int i = 0; i < 5; ++i)
+		ASSERT_TRUE(current->contains(i), "missing element in set: %d", i);
+
+	return true;
+}
+
+bool test_rcu_map()
+{
+	ktl::rcu_ptr<ktl::flat_map<int, int>> routes;
+
+	ktl::flat_map<int, int> initial;
+	for (int i = 0; i < 100; ++i)
+		ASSERT_TRUE(initial.insert(i, i * 2) != initial.end(), "failed to insert into flat_map");
+
+	ASSERT_TRUE(routes.publish(ktl::move(initial)), "failed to publish initial map");
+
+	// update() copies the published map with flat_map::copy().
+	ASSERT_TRUE(routes.update([](ktl::flat_map<int, int>& draft)
+	{
+		(void)draft.erase(0);
+		return draft.insert(100, 200) != draft.end();
+	}), "failed to update rcu_ptr");
+
+	auto current = routes.read();
+	ASSERT_TRUE(current->size() == 100, "unexpected size of map after update: %llu", current->size());
+	ASSERT_FALSE(current->contains(0), "erased key was still in the published map");
+
+	for (int i = 1; i <= 100; ++i)
+	{
+		auto element = current->find(i);
+		ASSERT_TRUE(element, "missing key in published map: %d", i);
+
+		const auto& [key, value] = *element;
+		ASSERT_TRUE(key == i && value == i * 2, "unexpected element in published map: %d, %d", key, value);
+	}
+
+	return true;
+}
+
+bool test_rcu_reclaim()
+{
+	struct version
+	{
+		int Number = 0;
+		volatile LONG* Destroyed = nullptr;
+
+		~version()
+		{
+			if (Destroyed)
+				InterlockedIncrement(Destroyed);
+		}
+	};
+
+	struct
+	{
+		ktl::rcu_ptr<version>* Table;
+		volatile LONG Holding;
+		volatile LONG Updating;
+		volatile LONG* OldDestroyed;
+		bool SawNewVersion;
+		bool OldAliveWhileHeld;
+
+		void operator()()
+		{
+			auto held = Table->read();
+			InterlockedExchange(&Holding, 1);
+
+			while (!ReadAcquire(&Updating))
+				YieldProcessor();
+
+			// The writer is blocked on this snapshot: wait for it to publish the new version,
+			// then check the old one hasn't been reclaimed from under us.
+			LARGE_INTEGER interval;
+			interval.QuadPart = -10 * 1000; // 1ms
+
+			for (int i = 0; i < 5000 && !SawNewVersion; ++i)
+			{
+				auto latest = Table->read();
+				SawNewVersion = latest && latest->Number == 2;
+
+				if (!SawNewVersion)
+					KeDelayExecutionThread(KernelMode, FALSE, &interval);
+			}
+
+			OldAliveWhileHeld = held->Number == 1 && ReadAcquire(OldDestroyed) == 0;
+			held.reset();
+		}
+	} reader{};
+
+	volatile LONG oldDestroyed = 0;
+	volatile LONG newDestroyed = 0;
+
+	{
+		ktl::rcu_ptr<version> table;
+		ASSERT_TRUE(table.publish(version{ 1, &oldDestroyed }), "failed to publish initial version");
+
+		// The temporary published from was destroyed too.
+		InterlockedExchange(&oldDestroyed, 0);
+
+		reader.Table = &table;
+		reader.OldDestroyed = &oldDestroyed;
+
+		test_thread thread{ reader };
+		ASSERT_TRUE(NT_SUCCESS(thread.start()), "failed to start reader thread");
+
+		while (!ReadAcquire(&reader.Holding))
+			YieldProcessor();
+
+		InterlockedExchange(&reader.Updating, 1);
+
+		bool updated = table.update([&newDestroyed](version& draft)
+		{
+			draft.Number = 2;
+			draft.Destroyed = &newDestroyed;
+			return true;
+		});
+
+		// update() only returns once the reader released the old version, and reclaimed it.
+		thread.join();
+
+		ASSERT_TRUE(updated, "failed to update rcu_ptr");
+		ASSERT_TRUE(reader.SawNewVersion, "new version wasn't published while the old one was held");
+		ASSERT_TRUE(reader.OldAliveWhileHeld, "old version was reclaimed while a snapshot still held it");
+		ASSERT_TRUE(oldDestroyed == 1, "old version wasn't reclaimed once released: %d", oldDestroyed);
+		ASSERT_TRUE(newDestroyed == 0, "current version was reclaimed");
+	}
+
+	ASSERT_TRUE(newDestroyed == 1, "current version wasn't destroyed with the rcu_ptr: %d", newDestroyed);
+	return true;
+}
+
+bool test_rcu()
+{
+	__try
+	{
+		if (!test_rcu_vector())
+			return false;
+
+		if (!test_rcu_set())
+			return false;
+
+		if (!test_rcu_map())
+			return false;
+
+		if (!test_rcu_reclaim())
+			return false;
+	}
+	__except (EXCEPTION_EXECUTE_HANDLER)
+	{
+		LOG_ERROR("[NG]: %#x\n", GetExceptionCode());
+		return false;
+	}
+
+	LOG_TRACE("[OK] ktl::rcu!\n");
+	return true;
+}
\ No newline at end of file
@@ -144,6 +144,81 @@ bool test_set_copy()
 	return true;
 }
 
+bool test_set_batch()
+{
+	ktl::unordered_set<int> intSet;
+
+	for (int i = 0; i < 1000; ++i)
+		ASSERT_TRUE(intSet.insert(i * 2), "failed to insert element %d into set", i * 2);
+
+	// More keys than a single batch, and a partial batch at the end.
+	int keys[100];
+	bool results[100];
+
+	for (int i = 0; i < 100; ++i)
+		keys[i] = i * 3;
+
+	size_t found = intSet.contains_batch(keys, 100, results);
+
+	size_t expected = 0;
+	for (int i = 0; i < 100; ++i)
+	{
+		ASSERT_TRUE(results[i] == (keys[i] % 2 == 0), "unexpected batch result for %d", keys[i]);
+		expected += results[i] ? 1 : 0;
+	}
+
+	ASSERT_TRUE(found == expected, "unexpected number of keys found in batch: %llu", found);
+
+	ktl::unordered_set<int> emptySet;
+	ASSERT_TRUE(emptySet.contains_batch(keys, 100, results) == 0 && !results[0], "empty set contained keys");
+
+	return true;
+}
+
+bool test_set_stats()
+{
+	ktl::unordered_set<int> intSet;
+
+	for (int i = 0; i < 1000; ++i)
+		ASSERT_TRUE(intSet.insert(i), "failed to insert element %d into set", i);
+
+	auto stats = intSet.stats();
+	ASSERT_TRUE(stats.Size == 1000 && stats.BucketCount == intSet.bucket_count(), "unexpected set stats sizes");
+	ASSERT_TRUE(stats.Rehashes > 0, "growth wasn't counted as a rehash");
+	ASSERT_TRUE(stats.EmptyBuckets == stats.BucketLengths[0], "empty buckets didn't match histogram");
+
+	size_t buckets = 0;
+	for (auto count : stats.BucketLengths)
+		buckets += count;
+
+	ASSERT_TRUE(buckets == stats.BucketCount && stats.MaxBucketLength > 0, "bucket histogram didn't cover every bucket");
+
+	return true;
+}
+
+bool test_set_seeded()
+{
+	ktl::unordered_set<ktl::unicode_string<>> names{ ktl::random_seed };
+
+	ASSERT_TRUE(names.insert(ktl::unicode_string_view{ L"\\Device\\Afd" }), "failed to insert string into seeded set");
+	ASSERT_TRUE(names.insert(ktl::unicode_string_view{ L"\\Device\\Tcp" }), "failed to insert string into seeded set");
+	ASSERT_TRUE(names.find(ktl::unicode_string_view{ L"\\Device\\Tcp" }) != names.end(), "failed to find string in seeded set");
+
+	ktl::unordered_set<ULONG64> ids{ ktl::random_seed };
+
+	for (ULONG64 i = 0; i < 5000; ++i)
+		ASSERT_TRUE(ids.insert(i * 7), "failed to insert element %llu into seeded set", i * 7);
+
+	for (ULONG64 i = 0; i < 5000; ++i)
+		ASSERT_TRUE(ids.contains(i * 7) && !ids.contains(i * 7 + 1), "unexpected result looking up %llu in seeded set", i * 7);
+
+	auto copied = ids.copy();
+	ASSERT_TRUE(copied.has_value() && copied->size() == ids.size(), "failed to copy seeded set");
+	ASSERT_TRUE(copied->contains(700) && !copied->contains(701), "unexpected result looking up copied seeded set");
+
+	return true;
+}
+
 bool test_set()
 {
 	__try
@@ -157,6 +232,15 @@ bool test_set()
 		if (!test_set_copy())
 			return false;
 
+		if (!test_set_batch())
+			return false;
+
+		if (!test_set_stats())
+			return false;
+
+		if (!test_set_seeded())
+			return false;
+
 	}
 	__except (EXCEPTION_EXECUTE_HANDLER)
 	{
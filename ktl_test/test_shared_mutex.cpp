@@ -0,0 +1,176 @@
+#include "test.h"
+
+#include <mutex>
+#include <shared_mutex>
+
+namespace
+{
+	// ERESOURCE is recursive for its owner, so attempts which must fail have to come from another thread.
+	template<class mutex_type>
+	struct try_from_other_thread
+	{
+		mutex_type* Lock;
+		bool Exclusive = false;
+		bool Shared = false;
+
+		void operator()()
+		{
+			Exclusive = Lock->try_lock();
+			if (Exclusive)
+				Lock->unlock();
+
+			Shared = Lock->try_lock_shared();
+			if (Shared)
+				Lock->unlock_shared();
+		}
+	};
+
+	template<class mutex_type>
+	bool try_lock_from_other_thread(mutex_type& lock, bool& exclusive, bool& shared)
+	{
+		try_from_other_thread<mutex_type> attempt{ &lock };
+		test_thread thread{ attempt };
+
+		if (!NT_SUCCESS(thread.start()))
+			return false;
+
+		thread.join();
+
+		exclusive = attempt.Exclusive;
+		shared = attempt.Shared;
+		return true;
+	}
+}
+
+bool test_shared_mutex_eresource()
+{
+	ktl::shared_mutex lock;
+	ASSERT_TRUE(lock, "shared_mutex failed to initialize");
+
+	bool exclusive;
+	bool shared;
+
+	{
+		ktl::unique_lock guard{ lock };
+		ASSERT_TRUE(guard.owns_lock(), "unique_lock didn't own the shared_mutex");
+
+		ASSERT_TRUE(try_lock_from_other_thread(lock, exclusive, shared), "failed to start contending thread");
+		ASSERT_FALSE(exclusive, "try_lock succeeded under an exclusive holder");
+		ASSERT_FALSE(shared, "try_lock_shared succeeded under an exclusive holder");
+	}
+
+	{
+		ktl::shared_lock guard{ lock };
+		ASSERT_TRUE(guard.owns_lock(), "shared_lock didn't own the shared_mutex");
+
+		ASSERT_TRUE(try_lock_from_other_thread(lock, exclusive, shared), "failed to start contending thread");
+		ASSERT_FALSE(exclusive, "try_lock succeeded under a shared holder");
+		ASSERT_TRUE(shared, "try_lock_shared failed under a shared holder");
+
+		guard.unlock();
+		ASSERT_FALSE(guard.owns_lock(), "shared_lock still owned the shared_mutex after unlock");
+
+		ASSERT_TRUE(try_lock_from_other_thread(lock, exclusive, shared), "failed to start contending thread");
+		ASSERT_TRUE(exclusive, "try_lock failed after shared_lock::unlock");
+
+		ASSERT_TRUE(guard.try_lock(), "shared_lock::try_lock failed on a free shared_mutex");
+	}
+
+	// Both guards have gone out of scope, so the lock must be free.
+	ASSERT_TRUE(try_lock_from_other_thread(lock, exclusive, shared), "failed to start contending thread");
+	ASSERT_TRUE(exclusive && shared, "shared_mutex was still held after its guards were destroyed");
+
+	{
+		ktl::unique_lock guard{ lock };
+		guard.unlock();
+		ASSERT_TRUE(guard.try_lock(), "unique_lock::try_lock failed on a free shared_mutex");
+	}
+
+	ASSERT_TRUE(try_lock_from_other_thread(lock, exclusive, shared), "failed to start contending thread");
+	ASSERT_TRUE(exclusive && shared, "unique_lock didn't release the shared_mutex");
+
+	return true;
+}
+
+bool test_shared_mutex_spin_rw_lock()
+{
+	ktl::spin_rw_lock lock;
+	KIRQL oldIrql = KeGetCurrentIrql();
+
+	// EX_SPIN_LOCK isn't recursive, so a failed attempt can come from the holding thread.
+	{
+		ktl::unique_lock guard{ lock };
+		ASSERT_TRUE(KeGetCurrentIrql() == DISPATCH_LEVEL, "spin_rw_lock didn't raise to DISPATCH_LEVEL: %u", KeGetCurrentIrql());
+		ASSERT_FALSE(lock.try_lock_at_dpc_level(), "try_lock succeeded under an exclusive holder");
+		ASSERT_FALSE(lock.try_lock_shared_at_dpc_level(), "try_lock_shared succeeded under an exclusive holder");
+	}
+
+	ASSERT_TRUE(KeGetCurrentIrql() == oldIrql, "unique_lock didn't restore the previous IRQL: %u", KeGetCurrentIrql());
+
+	{
+		ktl::shared_lock guard{ lock };
+		ASSERT_TRUE(KeGetCurrentIrql() == DISPATCH_LEVEL, "spin_rw_lock didn't raise to DISPATCH_LEVEL: %u", KeGetCurrentIrql());
+		ASSERT_FALSE(lock.try_lock_at_dpc_level(), "try_lock succeeded under a shared holder");
+
+		bool shared = lock.try_lock_shared_at_dpc_level();
+		if (shared)
+			lock.unlock_shared_from_dpc_level();
+
+		ASSERT_TRUE(shared, "try_lock_shared failed under a shared holder");
+
+		guard.unlock();
+		ASSERT_FALSE(guard.owns_lock(), "shared_lock still owned the spin_rw_lock after unlock");
+		ASSERT_TRUE(KeGetCurrentIrql() == oldIrql, "shared_lock::unlock didn't restore the previous IRQL: %u", KeGetCurrentIrql());
+
+		guard.lock();
+		ASSERT_TRUE(guard.owns_lock(), "shared_lock didn't reacquire the spin_rw_lock");
+	}
+
+	ASSERT_TRUE(KeGetCurrentIrql() == oldIrql, "shared_lock didn't restore the previous IRQL: %u", KeGetCurrentIrql());
+
+	// Both guards have gone out of scope, so the lock must be free.
+	{
+		KIRQL irql = lock.lock_shared();
+		bool converted = lock.try_convert_shared_to_exclusive();
+
+		if (converted)
+			lock.unlock(irql);
+		else
+			lock.unlock_shared(irql);
+
+		ASSERT_TRUE(converted, "failed to convert the only shared holder to exclusive");
+	}
+
+	{
+		ktl::spin_lock other;
+		ktl::scoped_lock raised{ other };
+
+		bool exclusive = lock.try_lock_at_dpc_level();
+		if (exclusive)
+			lock.unlock_from_dpc_level();
+
+		ASSERT_TRUE(exclusive, "spin_rw_lock was still held after its guards were destroyed");
+	}
+
+	return true;
+}
+
+bool test_shared_mutex()
+{
+	__try
+	{
+		if (!test_shared_mutex_eresource())
+			return false;
+
+		if (!test_shared_mutex_spin_rw_lock())
+			return false;
+	}
+	__except (EXCEPTION_EXECUTE_HANDLER)
+	{
+		LOG_ERROR("[NG]: %#x\n", GetExceptionCode());
+		return false;
+	}
+
+	LOG_TRACE("[OK] ktl::shared_mutex!\n");
+	return true;
+}
\ No newline at end of file
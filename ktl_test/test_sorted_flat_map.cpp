@@ -0,0 +1,139 @@
+#include "test.h"
+
+#include <sorted_flat_map>
+#include <sorted_flat_set>
+
+bool test_sorted_flat_map_layout(ktl::sorted_layout layout)
+{
+	ktl::sorted_flat_map<int, int> map;
+
+	// Insert out of order, with a duplicate key whose later value should win.
+	for (int i = 999; i >= 0; --i)
+		ASSERT_TRUE(map.insert(i * 2, i), "failed to insert into sorted_flat_map");
+
+	ASSERT_TRUE(map.insert(10, -1), "failed to insert duplicate key into sorted_flat_map");
+	ASSERT_FALSE(map.contains(10), "unfrozen sorted_flat_map reported a key");
+	ASSERT_TRUE(map.freeze(layout), "failed to freeze sorted_flat_map");
+	ASSERT_TRUE(map.size() == 1000, "unexpected size after freezing: %llu", map.size());
+
+	auto it = map.find(10);
+	ASSERT_TRUE(it != map.end(), "failed to find key in sorted_flat_map");
+	ASSERT_TRUE(it.value() == -1, "duplicate key didn't keep the last inserted value: %d", it.value());
+
+	ASSERT_TRUE(map.find(11) == map.end(), "found key which was never inserted");
+	ASSERT_TRUE(map.find(-1) == map.end(), "found key below the smallest key");
+	ASSERT_TRUE(map.find(5000) == map.end(), "found key above the largest key");
+
+	for (int i = 0; i < 1999; ++i)
+	{
+		auto lower = map.lower_bound(i);
+		int expected = (i + 1) / 2 * 2;
+		ASSERT_TRUE(lower != map.end() && lower.key() == expected, "unexpected lower_bound for %d", i);
+	}
+
+	ASSERT_TRUE(map.lower_bound(1999) == map.end(), "lower_bound above the largest key wasn't end");
+	ASSERT_TRUE(map.upper_bound(1998) == map.end(), "upper_bound of the largest key wasn't end");
+	ASSERT_TRUE(map.upper_bound(4).key() == 6, "unexpected upper_bound");
+
+	int previous = -1;
+	size_t count = 0;
+
+	for (auto [key, value] : map)
+	{
+		ASSERT_TRUE(key > previous, "sorted_flat_map iteration was out of order");
+		previous = key;
+		++count;
+	}
+
+	ASSERT_TRUE(count == map.size(), "iteration visited %llu of %llu elements", count, map.size());
+
+	count = 0;
+	for (auto [key, value] : map.range(100, 200))
+	{
+		ASSERT_TRUE(key >= 100 && key < 200, "range returned key %d outside of [100, 200)", key);
+		++count;
+	}
+
+	ASSERT_TRUE(count == 50, "unexpected number of elements in range: %llu", count);
+	ASSERT_TRUE(map.range(200, 100).empty(), "inverted range wasn't empty");
+
+	// Inserting after freezing requires another freeze.
+	ASSERT_TRUE(map.insert(1, 1), "failed to insert into frozen sorted_flat_map");
+	ASSERT_FALSE(map.frozen(), "sorted_flat_map was still frozen after insertion");
+	ASSERT_TRUE(map.freeze(layout), "failed to refreeze sorted_flat_map");
+	ASSERT_TRUE(map.contains(1), "key inserted after freezing wasn't found");
+
+	const auto& constMap = map;
+	ASSERT_TRUE(constMap.find(1).value() == 1, "const find returned the wrong value");
+
+	return true;
+}
+
+bool test_sorted_flat_map_strings()
+{
+	ktl::sorted_flat_map<ktl::unicode_string<>, int> map;
+
+	ASSERT_TRUE(map.insert(ktl::unicode_string<>{ L"\\Device\\B" }, 2), "failed to insert into sorted_flat_map");
+	ASSERT_TRUE(map.insert(ktl::unicode_string<>{ L"\\Device\\A" }, 1), "failed to insert into sorted_flat_map");
+	ASSERT_TRUE(map.insert(ktl::unicode_string<>{ L"\\Device\\C" }, 3), "failed to insert into sorted_flat_map");
+
+	// Keys which aren't trivially copyable silently use the sorted layout.
+	ASSERT_TRUE(map.freeze(ktl::sorted_layout::eytzinger), "failed to freeze sorted_flat_map");
+
+	auto it = map.find(ktl::unicode_string_view{ L"\\Device\\B" });
+	ASSERT_TRUE(it != map.end() && it.value() == 2, "failed to find string key");
+	ASSERT_TRUE((*map.begin()).Value == 1, "smallest string key wasn't first");
+
+	return true;
+}
+
+bool test_sorted_flat_set()
+{
+	ktl::sorted_flat_set<ULONG_PTR> set;
+
+	for (ULONG_PTR i = 0; i < 512; ++i)
+		ASSERT_TRUE(set.insert((i * 7919) % 512), "failed to insert into sorted_flat_set");
+
+	for (ULONG_PTR i = 0; i < 512; i += 2)
+		ASSERT_TRUE(set.insert(i), "failed to insert duplicate into sorted_flat_set");
+
+	ASSERT_TRUE(set.freeze(ktl::sorted_layout::eytzinger), "failed to freeze sorted_flat_set");
+	ASSERT_TRUE(set.size() == 512, "duplicates weren't removed: %llu", set.size());
+
+	for (ULONG_PTR i = 0; i < 512; ++i)
+		ASSERT_TRUE(set.contains(i), "sorted_flat_set didn't contain %llu", i);
+
+	ASSERT_FALSE(set.contains(512), "sorted_flat_set contained a key which was never inserted");
+
+	auto range = set.range(10, 20);
+	ASSERT_TRUE(range.end() - range.begin() == 10, "unexpected range size");
+	ASSERT_TRUE(*range.begin() == 10, "range didn't start at its low key");
+
+	return true;
+}
+
+bool test_sorted_flat_map()
+{
+	__try
+	{
+		if (!test_sorted_flat_map_layout(ktl::sorted_layout::sorted))
+			return false;
+
+		if (!test_sorted_flat_map_layout(ktl::sorted_layout::eytzinger))
+			return false;
+
+		if (!test_sorted_flat_map_strings())
+			return false;
+
+		if (!test_sorted_flat_set())
+			return false;
+	}
+	__except (EXCEPTION_EXECUTE_HANDLER)
+	{
+		LOG_ERROR("[NG]: %#x\n", GetExceptionCode());
+		return false;
+	}
+
+	LOG_TRACE("[OK] ktl::sorted_flat_map!\n");
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+#include "test.h"
+
+#include <thread_pool>
+
+bool test_thread_pool_submit(ktl::thread_pool& pool)
+{
+	volatile LONG counter = 0;
+	ktl::task_handle handles[64];
+
+	for (auto& handle : handles)
+	{
+		handle = pool.submit([&counter]() { InterlockedIncrement(&counter); });
+		ASSERT_TRUE(handle, "failed to submit task to thread pool");
+	}
+
+	for (auto& handle : handles)
+		handle.wait();
+
+	for (auto& handle : handles)
+		ASSERT_TRUE(handle.is_ready(), "task was not complete after waiting");
+
+	ASSERT_TRUE(counter == 64, "unexpected number of tasks executed: %d", counter);
+	return true;
+}
+
+bool test_thread_pool_nested(ktl::thread_pool& pool)
+{
+	volatile LONG counter = 0;
+
+	// Each task fans out into children, and waits on them from inside the pool.
+	auto parent = pool.submit([&pool, &counter]()
+	{
+		ktl::task_handle children[16];
+
+		for (auto& child : children)
+			child = pool.submit([&counter]() { InterlockedIncrement(&counter); });
+
+		for (auto& child : children)
+			child.wait();
+	});
+
+	ASSERT_TRUE(parent, "failed to submit parent task to thread pool");
+	parent.wait();
+
+	ASSERT_TRUE(counter == 16, "unexpected number of nested tasks executed: %d", counter);
+	return true;
+}
+
+bool test_thread_pool_wait_depth(ktl::thread_pool& pool)
+{
+	volatile LONG counter = 0;
+	ktl::task_handle parents[256];
+
+	// Far more waiting tasks than workers, all injected at once: a worker waiting on its child
+	// would otherwise keep picking up the next parent, nesting one stack frame set per parent.
+	for (auto& parent : parents)
+	{
+		parent = pool.submit([&pool, &counter]()
+		{
+			auto child = pool.submit([&counter]() { InterlockedIncrement(&counter); });
+			child.wait();
+			InterlockedIncrement(&counter);
+		});
+
+		ASSERT_TRUE(parent, "failed to submit parent task to thread pool");
+	}
+
+	for (auto& parent : parents)
+		parent.wait();
+
+	ASSERT_TRUE(counter == 512, "unexpected number of nested tasks executed: %d", counter);
+	return true;
+}
+
+bool test_thread_pool()
+{
+	__try
+	{
+		ktl::thread_pool pool;
+
+		ASSERT_FALSE(pool.submit([]() {}), "submit succeeded on a pool which wasn't started");
+		ASSERT_TRUE(NT_SUCCESS(pool.start()), "failed to start thread pool");
+		ASSERT_TRUE(pool.size() > 0, "thread pool started without workers");
+
+		if (!test_thread_pool_submit(pool))
+			return false;
+
+		if (!test_thread_pool_nested(pool))
+			return false;
+
+		if (!test_thread_pool_wait_depth(pool))
+			return false;
+
+		pool.stop();
+		ASSERT_TRUE(pool.size() == 0, "thread pool still had workers after stopping");
+	}
+	__except (EXCEPTION_EXECUTE_HANDLER)
+	{
+		LOG_ERROR("[NG]: %#x\n", GetExceptionCode());
+		return false;
+	}
+
+	LOG_TRACE("[OK] ktl::thread_pool!\n");
+	return true;
+}
\ No newline at end of file
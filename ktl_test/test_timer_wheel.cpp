@@ -0,0 +1,154 @@
+#include "test.h"
+
+#include <timer_wheel>
+
+struct expiring_item
+{
+	ULONG64 Deadline = 0;
+	ULONG64 ExpiredAt = 0;
+	ULONG Expirations = 0;
+	ktl::timer_wheel_entry Timer;
+};
+
+bool test_timer_wheel_expiry(ktl::timer_wheel<>& wheel)
+{
+	constexpr size_t Count = 2000;
+	static expiring_item items[Count];
+
+	// Deadlines spread over several levels of the wheel.
+	for (size_t i = 0; i < Count; ++i)
+	{
+		items[i].Deadline = (i * 7919) % 300000 + 1;
+		wheel.schedule(items[i].Timer, items[i].Deadline);
+	}
+
+	ASSERT_TRUE(wheel.size() == Count, "unexpected timer_wheel size: %llu", wheel.size());
+
+	// Cancel every third item.
+	for (size_t i = 0; i < Count; i += 3)
+		ASSERT_TRUE(wheel.cancel(items[i].Timer), "failed to cancel scheduled item %llu", i);
+
+	ASSERT_FALSE(wheel.cancel(items[0].Timer), "cancelled an item twice");
+
+	size_t expired = 0;
+	bool ordered = true;
+	ULONG64 last = 0;
+
+	for (ULONG64 now = 0; now <= 300000; now += 997)
+	{
+		expired += wheel.advance(now, [&](ktl::timer_wheel_entry& entry)
+		{
+			auto item = CONTAINING_RECORD(&entry, expiring_item, Timer);
+
+			// Expired during this advance, no earlier than its deadline, in deadline order.
+			if (item->Deadline > now || item->Deadline + 997 <= now || item->Deadline < last)
+				ordered = false;
+
+			last = item->Deadline;
+			item->ExpiredAt = now;
+			++item->Expirations;
+		});
+	}
+
+	expired += wheel.advance(300001, [](ktl::timer_wheel_entry& entry)
+	{
+		++CONTAINING_RECORD(&entry, expiring_item, Timer)->Expirations;
+	});
+
+	ASSERT_TRUE(ordered, "timer_wheel expired items at the wrong time");
+	ASSERT_TRUE(expired == Count - (Count + 2) / 3, "unexpected number of expired items: %llu", expired);
+	ASSERT_TRUE(wheel.empty(), "timer_wheel still held items after they all expired");
+
+	for (size_t i = 0; i < Count; ++i)
+	{
+		ULONG expected = i % 3 == 0 ? 0 : 1;
+		ASSERT_TRUE(items[i].Expirations == expected, "item %llu expired %lu times", i, items[i].Expirations);
+	}
+
+	return true;
+}
+
+bool test_timer_wheel_reschedule(ktl::timer_wheel<>& wheel)
+{
+	expiring_item periodic;
+	expiring_item distant;
+
+	wheel.schedule_after(periodic.Timer, 10);
+
+	// Beyond the 2^36 ticks the wheel covers.
+	distant.Deadline = wheel.now() + (1ull << 40);
+	wheel.schedule(distant.Timer, distant.Deadline);
+
+	// Rescheduling from the callback gives a periodic timer.
+	for (int i = 0; i < 100; ++i)
+	{
+		(void)wheel.tick([&wheel](ktl::timer_wheel_entry& entry)
+		{
+			++CONTAINING_RECORD(&entry, expiring_item, Timer)->Expirations;
+			wheel.schedule_after(entry, 10);
+		});
+	}
+
+	ASSERT_TRUE(periodic.Expirations == 10, "periodic item expired %lu times", periodic.Expirations);
+	ASSERT_TRUE(wheel.cancel(periodic.Timer), "failed to cancel periodic item");
+
+	size_t expired = wheel.advance(distant.Deadline - 1, [](ktl::timer_wheel_entry&) {});
+	ASSERT_TRUE(expired == 0 && distant.Timer.scheduled(), "distant item expired early");
+
+	expired = wheel.advance(distant.Deadline, [](ktl::timer_wheel_entry&) {});
+	ASSERT_TRUE(expired == 1 && !distant.Timer.scheduled(), "distant item didn't expire on time");
+
+	return true;
+}
+
+void timer_wheel_expire_routine(ktl::timer_wheel_entry& entry, void* context)
+{
+	CONTAINING_RECORD(&entry, expiring_item, Timer)->Expirations++;
+	InterlockedIncrement(static_cast<volatile LONG*>(context));
+}
+
+bool test_timer_wheel_dpc(ktl::timer_wheel<>& wheel)
+{
+	volatile LONG expirations = 0;
+	expiring_item items[8];
+
+	ASSERT_TRUE(NT_SUCCESS(wheel.start(1, &timer_wheel_expire_routine, const_cast<LONG*>(&expirations))), "failed to start timer_wheel");
+
+	for (auto& item : items)
+		wheel.schedule_after(item.Timer, 5);
+
+	LARGE_INTEGER interval;
+	interval.QuadPart = -500 * 10000ll;
+	KeDelayExecutionThread(KernelMode, FALSE, &interval);
+
+	wheel.stop();
+
+	ASSERT_TRUE(expirations == ARRAYSIZE(items), "unexpected number of items expired by the timer: %ld", expirations);
+	return true;
+}
+
+bool test_timer_wheel()
+{
+	__try
+	{
+		auto wheel = new ktl::timer_wheel<>();
+		ASSERT_TRUE(wheel, "failed to allocate timer_wheel");
+
+		bool passed = test_timer_wheel_expiry(*wheel) &&
+			test_timer_wheel_reschedule(*wheel) &&
+			test_timer_wheel_dpc(*wheel);
+
+		delete wheel;
+
+		if (!passed)
+			return false;
+	}
+	__except (EXCEPTION_EXECUTE_HANDLER)
+	{
+		LOG_ERROR("[NG]: %#x\n", GetExceptionCode());
+		return false;
+	}
+
+	LOG_TRACE("[OK] ktl::timer_wheel!\n");
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,322 @@
+#pragma once
+
+// Shared-memory request ring between ktl-ctl and the driver.
+//
+// User mode allocates one region, initializes it with KtlRingInitialize, and registers it with
+// IOCTL_KTLTEST_RING_REGISTER. The driver locks the pages and maps them into system space, after which
+// both sides exchange fixed-size records through two single-producer/single-consumer rings without any
+// further buffer copies through the I/O manager:
+//
+//   Requests:  user mode produces, the driver consumes.
+//   Responses: the driver produces, user mode consumes.
+//
+// IOCTL_KTLTEST_RING_KICK tells the driver that requests are pending; a producer publishes a whole batch
+// with one release store, and only needs to kick once per batch.
+//
+// This header has no ktl dependencies, so it can be used from user mode, and from the kernel. Include
+// <Windows.h> or <ntddk.h> first.
+
+#define KTL_RING_MAGIC 'gniR'
+#define KTL_RING_VERSION 1UL
+#define KTL_RING_CACHE_LINE 64
+#define KTL_RING_PAYLOAD_SIZE 48
+
+typedef struct _KTL_RING_RECORD
+{
+    ULONG Operation;
+    ULONG Sequence;
+    LONG Status;
+    ULONG Length;
+    UCHAR Payload[KTL_RING_PAYLOAD_SIZE];
+} KTL_RING_RECORD, * PKTL_RING_RECORD;
+
+static_assert(sizeof(KTL_RING_RECORD) == KTL_RING_CACHE_LINE, "ring records should be one cache line");
+
+//
+// Ring operations handled by the test driver.
+//
+#define KTL_RING_OP_ECHO 1UL
+
+// Each index is written by one side only, and lives on its own cache line, so the producer and consumer
+// never write to the same line.
+typedef struct alignas(KTL_RING_CACHE_LINE) _KTL_RING_INDEX
+{
+    volatile ULONG Value;
+} KTL_RING_INDEX;
+
+typedef struct _KTL_RING_CONTROL
+{
+    // Next record to consume. Written by the consumer.
+    KTL_RING_INDEX Head;
+
+    // Next record to produce. Written by the producer.
+    KTL_RING_INDEX Tail;
+} KTL_RING_CONTROL, * PKTL_RING_CONTROL;
+
+typedef struct alignas(KTL_RING_CACHE_LINE) _KTL_RING_REGION
+{
+    ULONG Magic;
+    ULONG Version;
+    ULONG Capacity;
+    ULONG RecordSize;
+
+    KTL_RING_CONTROL Requests;
+    KTL_RING_CONTROL Responses;
+
+    // Followed by Capacity request records, then Capacity response records.
+} KTL_RING_REGION, * PKTL_RING_REGION;
+
+// Largest number of records per ring for which the whole region still fits in a ULONG, so its size can't
+// overflow a 32-bit SIZE_T, or the ULONG length the driver locks.
+#define KTL_RING_MAX_CAPACITY ((MAXULONG - sizeof(KTL_RING_REGION)) / (2 * sizeof(KTL_RING_RECORD)))
+
+/// <summary>
+/// The number of bytes needed for a region with the given number of records per ring. Only valid for
+/// capacities accepted by KtlRingValidCapacity.
+/// </summary>
+constexpr SIZE_T KtlRingRegionSize(ULONG capacity)
+{
+    return sizeof(KTL_RING_REGION) + 2 * static_cast<SIZE_T>(capacity) * sizeof(KTL_RING_RECORD);
+}
+
+constexpr bool KtlRingValidCapacity(ULONG capacity)
+{
+    return capacity >= 2 && capacity <= KTL_RING_MAX_CAPACITY && (capacity & (capacity - 1)) == 0;
+}
+
+inline bool KtlRingValidBuffer(PVOID buffer)
+{
+    return buffer && (reinterpret_cast<ULONG_PTR>(buffer) & (KTL_RING_CACHE_LINE - 1)) == 0;
+}
+
+inline PKTL_RING_RECORD KtlRingRequests(PKTL_RING_REGION region)
+{
+    return reinterpret_cast<PKTL_RING_RECORD>(region + 1);
+}
+
+inline PKTL_RING_RECORD KtlRingResponses(PKTL_RING_REGION region, ULONG capacity)
+{
+    return KtlRingRequests(region) + capacity;
+}
+
+/// <summary>
+/// Initializes an empty region in the buffer. Called by the side which owns the memory, before it is shared.
+/// </summary>
+/// <param name="capacity">Records per ring, a power of two.</param>
+inline bool KtlRingInitialize(PVOID buffer, SIZE_T size, ULONG capacity)
+{
+    if (!KtlRingValidBuffer(buffer) || !KtlRingValidCapacity(capacity) || size < KtlRingRegionSize(capacity))
+        return false;
+
+    auto region = static_cast<PKTL_RING_REGION>(buffer);
+    RtlZeroMemory(region, sizeof(KTL_RING_REGION));
+    region->Magic = KTL_RING_MAGIC;
+    region->Version = KTL_RING_VERSION;
+    region->Capacity = capacity;
+    region->RecordSize = sizeof(KTL_RING_RECORD);
+
+    return true;
+}
+
+/// <summary>
+/// Checks the header of a region shared by the other side, and returns its capacity.
+/// The header is read once; the caller must use the returned capacity, and never re-read it from the region.
+/// </summary>
+inline bool KtlRingValidate(PVOID buffer, SIZE_T size, ULONG& capacity)
+{
+    if (!KtlRingValidBuffer(buffer) || size < sizeof(KTL_RING_REGION))
+        return false;
+
+    auto region = static_cast<volatile KTL_RING_REGION*>(buffer);
+    if (region->Magic != KTL_RING_MAGIC || region->Version != KTL_RING_VERSION || region->RecordSize != sizeof(KTL_RING_RECORD))
+        return false;
+
+    capacity = region->Capacity;
+    return KtlRingValidCapacity(capacity) && size >= KtlRingRegionSize(capacity);
+}
+
+//
+// Each side keeps a private copy of the index it owns, and of the ring geometry. The index owned by the
+// other side is the only value read back from shared memory, and it is checked against the capacity
+// before use, so a misbehaving peer can't move either side outside of the record array.
+//
+// Records are always copied out of, and into, the ring. The driver never inspects a record in shared
+// memory, where user mode could change it between two reads.
+//
+
+struct KtlRingProducer
+{
+    bool attach(PKTL_RING_CONTROL control, PKTL_RING_RECORD records, ULONG capacity)
+    {
+        if (!KtlRingValidCapacity(capacity))
+            return false;
+
+        control_ = control;
+        records_ = records;
+        mask_ = capacity - 1;
+        tail_ = ReadULongNoFence(&control_->Tail.Value);
+        head_ = ReadULongAcquire(&control_->Head.Value);
+        broken_ = tail_ - head_ > capacity;
+
+        return !broken_;
+    }
+
+    /// <summary>
+    /// Copies up to count records into the ring, and publishes them together.
+    /// </summary>
+    /// <returns>The number of records written, which is less than count when the ring is full.</returns>
+    ULONG push(const KTL_RING_RECORD* records, ULONG count)
+    {
+        if (broken_)
+            return 0;
+
+        ULONG free = mask_ + 1 - (tail_ - head_);
+        if (free < count)
+        {
+            // Only touch the consumer's cache line when the cached view says we're out of room.
+            head_ = ReadULongAcquire(&control_->Head.Value);
+            if (tail_ - head_ > mask_ + 1)
+            {
+                broken_ = true;
+                return 0;
+            }
+
+            free = mask_ + 1 - (tail_ - head_);
+        }
+
+        count = count < free ? count : free;
+        if (count == 0)
+            return 0;
+
+        ULONG first = tail_ & mask_;
+        ULONG contiguous = mask_ + 1 - first;
+        if (contiguous > count)
+            contiguous = count;
+
+        RtlCopyMemory(records_ + first, records, contiguous * sizeof(KTL_RING_RECORD));
+        RtlCopyMemory(records_, records + contiguous, (count - contiguous) * sizeof(KTL_RING_RECORD));
+
+        tail_ += count;
+        WriteULongRelease(&control_->Tail.Value, tail_);
+
+        return count;
+    }
+
+    bool try_push(const KTL_RING_RECORD& record)
+    {
+        return push(&record, 1) == 1;
+    }
+
+    /// <summary>
+    /// The number of records which can be pushed without waiting for the consumer.
+    /// </summary>
+    ULONG available()
+    {
+        if (broken_)
+            return 0;
+
+        head_ = ReadULongAcquire(&control_->Head.Value);
+        if (tail_ - head_ > mask_ + 1)
+        {
+            broken_ = true;
+            return 0;
+        }
+
+        return mask_ + 1 - (tail_ - head_);
+    }
+
+    /// <summary>
+    /// True once the consumer has published an index which doesn't fit the ring. The ring is no longer used.
+    /// </summary>
+    bool broken() const
+    {
+        return broken_;
+    }
+
+private:
+    PKTL_RING_CONTROL control_ = nullptr;
+    PKTL_RING_RECORD records_ = nullptr;
+    ULONG mask_ = 0;
+    ULONG tail_ = 0;
+    ULONG head_ = 0;
+    bool broken_ = true;
+};
+
+struct KtlRingConsumer
+{
+    bool attach(PKTL_RING_CONTROL control, PKTL_RING_RECORD records, ULONG capacity)
+    {
+        if (!KtlRingValidCapacity(capacity))
+            return false;
+
+        control_ = control;
+        records_ = records;
+        mask_ = capacity - 1;
+        head_ = ReadULongNoFence(&control_->Head.Value);
+        tail_ = ReadULongAcquire(&control_->Tail.Value);
+        broken_ = tail_ - head_ > capacity;
+
+        return !broken_;
+    }
+
+    /// <summary>
+    /// Copies up to count records out of the ring, and releases their slots to the producer together.
+    /// </summary>
+    /// <returns>The number of records read, zero when the ring is empty.</returns>
+    ULONG pop(PKTL_RING_RECORD records, ULONG count)
+    {
+        if (broken_)
+            return 0;
+
+        ULONG ready = tail_ - head_;
+        if (ready < count)
+        {
+            tail_ = ReadULongAcquire(&control_->Tail.Value);
+            if (tail_ - head_ > mask_ + 1)
+            {
+                broken_ = true;
+                return 0;
+            }
+
+            ready = tail_ - head_;
+        }
+
+        count = count < ready ? count : ready;
+        if (count == 0)
+            return 0;
+
+        ULONG first = head_ & mask_;
+        ULONG contiguous = mask_ + 1 - first;
+        if (contiguous > count)
+            contiguous = count;
+
+        RtlCopyMemory(records, records_ + first, contiguous * sizeof(KTL_RING_RECORD));
+        RtlCopyMemory(records + contiguous, records_, (count - contiguous) * sizeof(KTL_RING_RECORD));
+
+        head_ += count;
+        WriteULongRelease(&control_->Head.Value, head_);
+
+        return count;
+    }
+
+    bool try_pop(KTL_RING_RECORD& record)
+    {
+        return pop(&record, 1) == 1;
+    }
+
+    /// <summary>
+    /// True once the producer has published an index which doesn't fit the ring. The ring is no longer used.
+    /// </summary>
+    bool broken() const
+    {
+        return broken_;
+    }
+
+private:
+    PKTL_RING_CONTROL control_ = nullptr;
+    PKTL_RING_RECORD records_ = nullptr;
+    ULONG mask_ = 0;
+    ULONG head_ = 0;
+    ULONG tail_ = 0;
+    bool broken_ = true;
+};
\ No newline at end of file
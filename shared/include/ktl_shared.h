@@ -32,4 +32,59 @@
     CTL_CODE( KTLTEST_TYPE, 0x809, METHOD_NEITHER , FILE_ANY_ACCESS  )
 
 #define IOCTL_KTLTEST_METHOD_MAP_TEST \
-    CTL_CODE( KTLTEST_TYPE, 0x80A, METHOD_NEITHER , FILE_ANY_ACCESS  )
\ No newline at end of file
+    CTL_CODE( KTLTEST_TYPE, 0x80A, METHOD_NEITHER , FILE_ANY_ACCESS  )
+
+#define IOCTL_KTLTEST_METHOD_RCU_TEST \
+    CTL_CODE( KTLTEST_TYPE, 0x80B, METHOD_NEITHER , FILE_ANY_ACCESS  )
+
+#define IOCTL_KTLTEST_METHOD_THREAD_POOL_TEST \
+    CTL_CODE( KTLTEST_TYPE, 0x80C, METHOD_NEITHER , FILE_ANY_ACCESS  )
+
+#define IOCTL_KTLTEST_METHOD_SORTED_FLAT_MAP_TEST \
+    CTL_CODE( KTLTEST_TYPE, 0x80D, METHOD_NEITHER , FILE_ANY_ACCESS  )
+
+#define IOCTL_KTLTEST_METHOD_BTREE_MAP_TEST \
+    CTL_CODE( KTLTEST_TYPE, 0x80E, METHOD_NEITHER , FILE_ANY_ACCESS  )
+
+#define IOCTL_KTLTEST_METHOD_PATH_TRIE_TEST \
+    CTL_CODE( KTLTEST_TYPE, 0x80F, METHOD_NEITHER , FILE_ANY_ACCESS  )
+
+#define IOCTL_KTLTEST_METHOD_MULTI_PATTERN_MATCHER_TEST \
+    CTL_CODE( KTLTEST_TYPE, 0x810, METHOD_NEITHER , FILE_ANY_ACCESS  )
+
+#define IOCTL_KTLTEST_METHOD_GLOB_TEST \
+    CTL_CODE( KTLTEST_TYPE, 0x811, METHOD_NEITHER , FILE_ANY_ACCESS  )
+
+#define IOCTL_KTLTEST_METHOD_BLOOM_FILTER_TEST \
+    CTL_CODE( KTLTEST_TYPE, 0x812, METHOD_NEITHER , FILE_ANY_ACCESS  )
+
+#define IOCTL_KTLTEST_METHOD_LRU_CACHE_TEST \
+    CTL_CODE( KTLTEST_TYPE, 0x813, METHOD_NEITHER , FILE_ANY_ACCESS  )
+
+#define IOCTL_KTLTEST_METHOD_TIMER_WHEEL_TEST \
+    CTL_CODE( KTLTEST_TYPE, 0x814, METHOD_NEITHER , FILE_ANY_ACCESS  )
+
+#define IOCTL_KTLTEST_METHOD_FROZEN_TEST \
+    CTL_CODE( KTLTEST_TYPE, 0x815, METHOD_NEITHER , FILE_ANY_ACCESS  )
+
+#define IOCTL_KTLTEST_METHOD_MUTEX_TEST \
+    CTL_CODE( KTLTEST_TYPE, 0x819, METHOD_NEITHER , FILE_ANY_ACCESS  )
+
+#define IOCTL_KTLTEST_METHOD_SHARED_MUTEX_TEST \
+    CTL_CODE( KTLTEST_TYPE, 0x81A, METHOD_NEITHER , FILE_ANY_ACCESS  )
+
+//
+// Shared-memory request ring, see ktl_ring.h.
+//
+// REGISTER: the input buffer is a KTL_RING_REGION initialized by KtlRingInitialize. It stays locked and
+//           mapped by the driver until UNREGISTER, or the handle which registered it is closed.
+// KICK: the driver drains pending requests, and returns the number handled in the bytes-returned count.
+//
+#define IOCTL_KTLTEST_RING_REGISTER \
+    CTL_CODE( KTLTEST_TYPE, 0x816, METHOD_NEITHER , FILE_ANY_ACCESS  )
+
+#define IOCTL_KTLTEST_RING_KICK \
+    CTL_CODE( KTLTEST_TYPE, 0x817, METHOD_NEITHER , FILE_ANY_ACCESS  )
+
+#define IOCTL_KTLTEST_RING_UNREGISTER \
+    CTL_CODE( KTLTEST_TYPE, 0x818, METHOD_NEITHER , FILE_ANY_ACCESS  )
\ No newline at end of file